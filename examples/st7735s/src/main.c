@@ -17,17 +17,6 @@ static inline void setup() {
     DDRA |= (1 << PA6) | (1 << PA7);
 }
 
-/**
- * @brief Converts an integer to a string representation.
- *
- * @param number The integer number to convert.
- * @param stringBuffer The buffer to store the string representation.
- */
-void convertIntToString(int number, char *stringBuffer) {
-    stringBuffer[0] = '0' + (number % 10);  // Get the last digit of the integer and convert it to a character
-    stringBuffer[1] = '\0';                 // Terminate the string with a null character
-}
-
 /**
  * @brief Continuously executes the main functionality of the program.
  *
@@ -57,9 +46,8 @@ static inline void loop() {
     static int counter = 0;  // Declare 'counter' as static to maintain its value between calls
 
     // Convert the counter to a string
-    char counterString[2];  // Character array to store the counter as string
-    convertIntToString(counter,
-                       counterString);  // Call the function to convert the counter to a string
+    char counterString[NUMFMT_BUFFER_SIZE];    // Character array to store the counter as string
+    NUMFMT_FormatInt(counter, counterString);  // Convert the counter to a string without sprintf
 
     // Draw the "Hello, world!" string
     ST77XX_DrawString(0, 0, helloWorldString, 0xFFFF, 0x0000);
@@ -93,6 +93,26 @@ static inline void loop() {
     ST77XX_DrawCircle(160, 100, 30, 0xFFE0);          // Yellow Circle
     ST77XX_DelayMs(2000);                             // Wait for 2 seconds
 
+    // Example 7: Segmented Digits
+    ST77XX_FillScreenWithColor(0x0000);  // Clear screen with black
+    SEGMENT_Display counter = {10, 60, 40, 72, 8, 12, 4, SEGMENT_TYPE_7, 0xF800, 0x2000, 0x0000, {0}};
+    SEGMENT_Init(&counter);
+    for (int16_t i = 0; i <= 1000; i += 37) {
+        SEGMENT_PrintFixed(&counter, i, 1);  // Only the segments that differ are repainted
+        ST77XX_DelayMs(100);
+    }
+    ST77XX_DelayMs(2000);  // Wait for 2 seconds
+
+    // Example 8: Status Strip in Partial and Idle Mode
+    ST77XX_FillRect(0, 0, ST77XX_GetWidth(), 16, 0x001F);
+    ST77XX_DrawString(4, 4, (char *)"Low power status", 0xFFFF, 0x001F);
+    ST77XX_SetPartialArea(0, 15);  // Only the top 16 rows are scanned
+    ST77XX_SetPartialMode(1);
+    ST77XX_SetIdleMode(1);
+    ST77XX_DelayMs(2000);  // Wait for 2 seconds
+    ST77XX_SetIdleMode(0);
+    ST77XX_SetPartialMode(0);
+
     // Draw random pixels to give an idea of module performance
     ST77XX_FillScreenWithColor(0x0000);  // Clear screen with black
     for (int i = 0; i < 100; i++) {
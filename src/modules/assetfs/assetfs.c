@@ -0,0 +1,167 @@
+/*
+ * Include the header file for the asset filesystem.
+ */
+#include "assetfs.h"
+
+#include <string.h>
+#include <util/crc16.h>
+
+#include "../../protocols/i2c/i2c.h"
+
+/*
+ * Offsets of the header fields.
+ */
+#define ASSETFS_MAGIC 0
+#define ASSETFS_FORMAT 2
+#define ASSETFS_COUNT 3
+#define ASSETFS_START 4
+#define ASSETFS_SIZE (ASSETFS_START + ASSETFS_BUCKETS)
+#define ASSETFS_CRC (ASSETFS_SIZE + 2)
+
+/*
+ * @brief Name looked up by ASSETFS_Open, and the extent ASSETFS_Match found for it.
+ */
+static const char *ASSETFS_lookupName;
+static ASSETFS_File ASSETFS_lookupFile;
+static uint8_t ASSETFS_lookupFound;
+
+/*
+ * @brief Computes the hash of a file name, as tools/assetpack does.
+ *
+ * @param name The file name.
+ * @return The hash; its low bits select the bucket.
+ */
+uint16_t ASSETFS_Hash(const char *name) {
+    uint16_t hash = 5381;
+    while (*name) {
+        hash = ((hash << 5) + hash) ^ (uint8_t)*name++;
+    }
+    return hash;
+}
+
+/*
+ * @brief Reads a little-endian 16-bit field.
+ *
+ * @param data The first byte of the field.
+ * @return The field value.
+ */
+static uint16_t ASSETFS_Field(const uint8_t *data) {
+    return data[0] | ((uint16_t)data[1] << 8);
+}
+
+/*
+ * @brief Mounts the image stored at an EEPROM address.
+ *
+ * @param fs The filesystem to mount.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param base The EEPROM address of the image.
+ * @return I2C_OK, ASSETFS_ERROR_CORRUPT, or the I2C error of the header read.
+ */
+uint8_t ASSETFS_Mount(ASSETFS_FileSystem *fs, uint16_t eepromAddress, uint16_t base) {
+    uint8_t header[ASSETFS_HEADER_SIZE];
+    fs->eepromAddress = eepromAddress;
+    fs->base = base;
+    fs->count = 0;
+
+    uint8_t status = AT24C256_Read(eepromAddress, base, header, sizeof(header));
+    if (status != I2C_OK) return status;
+
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < ASSETFS_CRC; i++) {
+        crc = _crc_ccitt_update(crc, header[i]);
+    }
+    if (header[ASSETFS_MAGIC] != 'A' || header[ASSETFS_MAGIC + 1] != 'F' ||
+        header[ASSETFS_FORMAT] != ASSETFS_VERSION || ASSETFS_Field(&header[ASSETFS_CRC]) != crc) {
+        return ASSETFS_ERROR_CORRUPT;
+    }
+
+    fs->count = header[ASSETFS_COUNT];
+    memcpy(fs->start, &header[ASSETFS_START], ASSETFS_BUCKETS);
+    return I2C_OK;
+}
+
+/*
+ * @brief Compares a directory entry with the name being looked up.
+ *
+ * @param entry The entry.
+ * @param length The size of the entry.
+ */
+static void ASSETFS_Match(const uint8_t *entry, uint16_t length) {
+    if (length == ASSETFS_ENTRY_SIZE && strncmp(ASSETFS_lookupName, (const char *)entry, ASSETFS_NAME_SIZE) == 0) {
+        ASSETFS_lookupFile.address = ASSETFS_Field(&entry[ASSETFS_NAME_SIZE]);
+        ASSETFS_lookupFile.length = ASSETFS_Field(&entry[ASSETFS_NAME_SIZE + 2]);
+        ASSETFS_lookupFound = 1;
+    }
+}
+
+/*
+ * @brief Looks up a file by name.
+ *
+ * @param fs The mounted filesystem.
+ * @param name The file name.
+ * @param file Receives the handle of the file.
+ * @return I2C_OK, ASSETFS_NOT_FOUND, or the I2C error of the directory read.
+ */
+uint8_t ASSETFS_Open(const ASSETFS_FileSystem *fs, const char *name, ASSETFS_File *file) {
+    if (strlen(name) > ASSETFS_NAME_SIZE) return ASSETFS_NOT_FOUND;
+
+    uint8_t bucket = ASSETFS_Hash(name) & (ASSETFS_BUCKETS - 1);
+    uint8_t first = fs->start[bucket];
+    uint8_t end = bucket + 1 < ASSETFS_BUCKETS ? fs->start[bucket + 1] : fs->count;
+    if (first >= end) return ASSETFS_NOT_FOUND;
+
+    // The whole bucket is read in one transfer, handing each entry to ASSETFS_Match
+    uint8_t entry[ASSETFS_ENTRY_SIZE];
+    ASSETFS_lookupName = name;
+    ASSETFS_lookupFound = 0;
+    uint8_t status = AT24C256_ReadChunks(fs->eepromAddress, fs->base + ASSETFS_DIRECTORY + first * ASSETFS_ENTRY_SIZE,
+                                         (end - first) * ASSETFS_ENTRY_SIZE, entry, sizeof(entry), ASSETFS_Match);
+    if (status != I2C_OK) return status;
+    if (!ASSETFS_lookupFound) return ASSETFS_NOT_FOUND;
+
+    file->address = fs->base + ASSETFS_lookupFile.address;
+    file->length = ASSETFS_lookupFile.length;
+    return I2C_OK;
+}
+
+/*
+ * @brief Reads bytes of a file.
+ *
+ * @param fs The mounted filesystem.
+ * @param file The handle of the file.
+ * @param offset The position of the first byte within the file.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to read.
+ * @return I2C_OK, ASSETFS_ERROR_RANGE, or the I2C error that ended the transfer.
+ */
+uint8_t ASSETFS_Read(const ASSETFS_FileSystem *fs, const ASSETFS_File *file, uint16_t offset, uint8_t *data,
+                     uint16_t length) {
+    if (offset > file->length || length > file->length - offset) return ASSETFS_ERROR_RANGE;
+    if (length == 0) return I2C_OK;
+
+    return AT24C256_Read(fs->eepromAddress, file->address + offset, data, length);
+}
+
+/*
+ * @brief Streams bytes of a file through a small buffer in one transfer.
+ *
+ * @param fs The mounted filesystem.
+ * @param file The handle of the file.
+ * @param offset The position of the first byte within the file.
+ * @param length The number of bytes to read.
+ * @param buffer Buffer that receives each chunk.
+ * @param bufferSize Size of the buffer, the largest chunk passed to the callback; at least 1.
+ * @param callback Function receiving each chunk; the bus waits while it runs.
+ * @return I2C_OK, ASSETFS_ERROR_RANGE, I2C_ERROR_INVALID if bufferSize is 0, or the I2C error that ended the
+ *         transfer.
+ *
+ * The chunks are delivered straight from the I2C receiver, so a font or image
+ * can go to the display without being copied or held in SRAM as a whole.
+ */
+uint8_t ASSETFS_Stream(const ASSETFS_FileSystem *fs, const ASSETFS_File *file, uint16_t offset, uint16_t length,
+                       uint8_t *buffer, uint16_t bufferSize, ASSETFS_Callback callback) {
+    if (offset > file->length || length > file->length - offset) return ASSETFS_ERROR_RANGE;
+    if (length == 0) return I2C_OK;
+
+    return AT24C256_ReadChunks(fs->eepromAddress, file->address + offset, length, buffer, bufferSize, callback);
+}
@@ -0,0 +1,156 @@
+/*
+ * Header guard to prevent multiple inclusions of the "assetfs.h" header file.
+ */
+#ifndef ASSETFS_H
+#define ASSETFS_H
+
+#include <stdint.h>
+
+#include "../at24c256/at24c256.h"
+
+/*
+ * Declarations of functions for the read-only asset filesystem on the AT24C256.
+ *
+ * Fonts, images and string tables are packed on the host by tools/assetpack
+ * into an image that is written to the EEPROM once. The image starts with a
+ * header page, followed by the directory and the file contents; every file is
+ * one contiguous extent. All fields are little-endian.
+ *
+ * Header (ASSETFS_HEADER_SIZE bytes at offset 0):
+ *   magic "AF" | version u8 | count u8 | start u8[ASSETFS_BUCKETS] | size u16 | CRC16
+ *
+ * Directory (count entries of ASSETFS_ENTRY_SIZE bytes at offset ASSETFS_DIRECTORY):
+ *   name char[ASSETFS_NAME_SIZE], NUL-padded | offset u16 | length u16
+ *
+ * Entries are sorted by the bucket of their name hash (see ASSETFS_Hash), and
+ * start[b] is the index of the first entry of bucket b; the bucket ends where
+ * the next one starts, or at count. The CRC is the CRC-CCITT of the header
+ * bytes before it, and size is the length of the whole image.
+ *
+ * ASSETFS_Mount reads the header once and keeps the bucket table in SRAM, so
+ * ASSETFS_Open reads only the entries of one bucket, in a single transfer.
+ * The returned file is a handle for ASSETFS_Read and ASSETFS_Stream.
+ */
+
+/*
+ * @brief Number of name hash buckets in the header.
+ */
+#define ASSETFS_BUCKETS 32
+
+/*
+ * @brief Longest file name; shorter names are padded with NUL bytes.
+ */
+#define ASSETFS_NAME_SIZE 12
+
+/*
+ * @brief Size of the header in bytes.
+ */
+#define ASSETFS_HEADER_SIZE (6 + ASSETFS_BUCKETS + 2)
+
+/*
+ * @brief Offset of the directory within the image; the header has a page of its own.
+ */
+#define ASSETFS_DIRECTORY AT24C256_PAGE_SIZE
+
+/*
+ * @brief Size of a directory entry in bytes.
+ */
+#define ASSETFS_ENTRY_SIZE (ASSETFS_NAME_SIZE + 4)
+
+/*
+ * @brief Version of the image format.
+ */
+#define ASSETFS_VERSION 1
+
+// Status codes besides the I2C ones
+#define ASSETFS_NOT_FOUND 0x50      // No file has the name
+#define ASSETFS_ERROR_CORRUPT 0x51  // The header is missing or damaged
+#define ASSETFS_ERROR_RANGE 0x52    // The access does not fit in the file
+
+/*
+ * @brief State of a mounted filesystem.
+ */
+typedef struct {
+    uint16_t eepromAddress;          // I2C address of the EEPROM device
+    uint16_t base;                   // EEPROM address of the image
+    uint8_t count;                   // Number of files
+    uint8_t start[ASSETFS_BUCKETS];  // Index of the first directory entry of each bucket
+} ASSETFS_FileSystem;
+
+/*
+ * @brief Handle of an open file.
+ */
+typedef struct {
+    uint16_t address;  // EEPROM address of the first byte
+    uint16_t length;   // Size in bytes
+} ASSETFS_File;
+
+/*
+ * @brief Function receiving the data of ASSETFS_Stream.
+ *
+ * @param data The bytes read, in the caller's buffer.
+ * @param length Number of bytes in data.
+ */
+typedef void (*ASSETFS_Callback)(const uint8_t *data, uint16_t length);
+
+/*
+ * @brief Computes the hash of a file name, as tools/assetpack does.
+ *
+ * @param name The file name.
+ * @return The hash; its low bits select the bucket.
+ */
+uint16_t ASSETFS_Hash(const char *name);
+
+/*
+ * @brief Mounts the image stored at an EEPROM address.
+ *
+ * @param fs The filesystem to mount.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param base The EEPROM address of the image.
+ * @return I2C_OK, ASSETFS_ERROR_CORRUPT, or the I2C error of the header read.
+ */
+uint8_t ASSETFS_Mount(ASSETFS_FileSystem *fs, uint16_t eepromAddress, uint16_t base);
+
+/*
+ * @brief Looks up a file by name.
+ *
+ * @param fs The mounted filesystem.
+ * @param name The file name.
+ * @param file Receives the handle of the file.
+ * @return I2C_OK, ASSETFS_NOT_FOUND, or the I2C error of the directory read.
+ */
+uint8_t ASSETFS_Open(const ASSETFS_FileSystem *fs, const char *name, ASSETFS_File *file);
+
+/*
+ * @brief Reads bytes of a file.
+ *
+ * @param fs The mounted filesystem.
+ * @param file The handle of the file.
+ * @param offset The position of the first byte within the file.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to read.
+ * @return I2C_OK, ASSETFS_ERROR_RANGE, or the I2C error that ended the transfer.
+ */
+uint8_t ASSETFS_Read(const ASSETFS_FileSystem *fs, const ASSETFS_File *file, uint16_t offset, uint8_t *data,
+                     uint16_t length);
+
+/*
+ * @brief Streams bytes of a file through a small buffer in one transfer.
+ *
+ * @param fs The mounted filesystem.
+ * @param file The handle of the file.
+ * @param offset The position of the first byte within the file.
+ * @param length The number of bytes to read.
+ * @param buffer Buffer that receives each chunk.
+ * @param bufferSize Size of the buffer, the largest chunk passed to the callback; at least 1.
+ * @param callback Function receiving each chunk; the bus waits while it runs.
+ * @return I2C_OK, ASSETFS_ERROR_RANGE, I2C_ERROR_INVALID if bufferSize is 0, or the I2C error that ended the
+ *         transfer.
+ *
+ * The chunks are delivered straight from the I2C receiver, so a font or image
+ * can go to the display without being copied or held in SRAM as a whole.
+ */
+uint8_t ASSETFS_Stream(const ASSETFS_FileSystem *fs, const ASSETFS_File *file, uint16_t offset, uint16_t length,
+                       uint8_t *buffer, uint16_t bufferSize, ASSETFS_Callback callback);
+
+#endif  // ASSETFS_H
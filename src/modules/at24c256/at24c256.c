@@ -9,6 +9,50 @@
 
 #include "../../protocols/i2c/i2c.h"
 
+/**
+ * @brief Prepares a transaction that starts by writing a memory address and does nothing else.
+ *
+ * @param transaction The transaction to prepare.
+ * @param eepromAddress The I2C address of the EEPROM device, shifted left as on the bus.
+ * @param address The memory address sent first, MSB first.
+ */
+static void AT24C256_InitTransaction(I2C_Transaction *transaction, uint16_t eepromAddress, uint16_t address) {
+    transaction->address = eepromAddress >> 1;
+    transaction->frequency = AT24C256_FREQUENCY;
+    transaction->prefix[0] = address >> 8;
+    transaction->prefix[1] = address & 0xFF;
+    transaction->prefixLength = 2;
+    transaction->writeData = NULL;
+    transaction->writeLength = 0;
+    transaction->readData = NULL;
+    transaction->readLength = 0;
+    transaction->chunkCallback = NULL;
+    transaction->chunkSize = 0;
+    transaction->callback = NULL;
+}
+
+/**
+ * @brief Runs one transaction that starts by writing a memory address.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device, shifted left as on the bus.
+ * @param address The memory address sent ahead of the data, MSB first.
+ * @param writeData Bytes written after the memory address, or NULL.
+ * @param writeLength Number of bytes in writeData.
+ * @param readData Buffer filled after a repeated start, or NULL.
+ * @param readLength Number of bytes to read into readData.
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+static uint8_t AT24C256_Transfer(uint16_t eepromAddress, uint16_t address, const uint8_t *writeData,
+                                 uint16_t writeLength, uint8_t *readData, uint16_t readLength) {
+    I2C_Transaction transaction;
+    AT24C256_InitTransaction(&transaction, eepromAddress, address);
+    transaction.writeData = writeData;
+    transaction.writeLength = writeLength;
+    transaction.readData = readData;
+    transaction.readLength = readLength;
+    return I2C_Transfer(&transaction);
+}
+
 /**
  * @brief Writes a byte to the AT24C256 EEPROM.
  *
@@ -16,22 +60,11 @@
  * @param address The memory address within the EEPROM where the data will be
  * written.
  * @param data The byte of data to be written to the EEPROM.
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void AT24C256_WriteByte(uint16_t eepromAddress, uint16_t address, uint8_t data) {
-    // Initiate a Start condition
-    I2C_Start();
-    // Write device address with RW bit set to 0 (write)
-    I2C_Write(eepromAddress);
-    // Write the high byte of the memory address (MSB)
-    I2C_Write(address >> 8);
-    // Write the low byte of the memory address (LSB)
-    I2C_Write(address & 0xFF);
-    // Write the data byte
-    I2C_Write(data);
-    // Terminate the transmission
-    I2C_Stop();
-    // Wait for the write cycle to complete
-    _delay_ms(5);
+uint8_t AT24C256_WriteByte(uint16_t eepromAddress, uint16_t address, uint8_t data) {
+    // Write the data byte and wait for the write cycle to complete
+    return AT24C256_Write(eepromAddress, address, &data, 1);
 }
 
 /**
@@ -43,25 +76,9 @@ void AT24C256_WriteByte(uint16_t eepromAddress, uint16_t address, uint8_t data)
  * @return The byte of data read from the EEPROM.
  */
 uint8_t AT24C256_ReadByte(uint16_t eepromAddress, uint16_t address) {
-    // Wait before reading the data
-    _delay_ms(10);
-    uint8_t data;
-    // Initiate a Start condition
-    I2C_Start();
-    // Write device address with RW bit set to 0 (write)
-    I2C_Write(eepromAddress);
-    // Write the high byte of the memory address (MSB)
-    I2C_Write(address >> 8);
-    // Write the low byte of the memory address (LSB)
-    I2C_Write(address & 0xFF);
-    // Re-initiate a Start condition
-    I2C_Start();
-    // Write device address with RW bit set to 1 (read)
-    I2C_Write(eepromAddress | 1);
-    // Read the data byte
-    data = I2C_ReadNack();
-    // Terminate the transmission
-    I2C_Stop();
+    uint8_t data = 0xFF;
+    // Wait for a pending write cycle, then read the data byte
+    AT24C256_Read(eepromAddress, address, &data, 1);
     // Return the read byte
     return data;
 }
@@ -74,26 +91,12 @@ uint8_t AT24C256_ReadByte(uint16_t eepromAddress, uint16_t address) {
  * data will be written.
  * @param data Pointer to the data array to be written.
  * @param pageSize The number of bytes to be written in one page (typically 64
- * bytes for AT24C256).
+ * bytes for AT24C256). Data crossing a page boundary continues on the next page.
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void AT24C256_WritePage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize) {
-    // Initiate a Start condition
-    I2C_Start();
-    // Write device address with RW bit set to 0 (write)
-    I2C_Write(eepromAddress);
-    // Write the high byte of the starting memory address (MSB)
-    I2C_Write(addressStart >> 8);
-    // Write the low byte of the starting memory address (LSB)
-    I2C_Write(addressStart & 0xFF);
-    // Write the page data
-    for (uint8_t i = 0; i < pageSize; i++) {
-        I2C_Write(data[i]);
-        _delay_ms(5);  // Small delay after each byte write (if necessary)
-    }
-    // Terminate the transmission
-    I2C_Stop();
-    // Wait for the write cycle to complete (minimum of 5 ms for AT24C256)
-    _delay_ms(5);
+uint8_t AT24C256_WritePage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize) {
+    // Write the page data and wait for the write cycle to complete
+    return AT24C256_Write(eepromAddress, addressStart, data, pageSize);
 }
 
 /**
@@ -105,28 +108,176 @@ void AT24C256_WritePage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *
  * @param data Pointer to the data array where the read data will be stored.
  * @param pageSize The number of bytes to be read in one page (typically 64
  * bytes for AT24C256).
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_ReadPage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize) {
+    // Wait for a pending write cycle, then read the page data
+    return AT24C256_Read(eepromAddress, addressStart, data, pageSize);
+}
+
+/**
+ * @brief Waits for the AT24C256 to finish its internal write cycle.
+ *
+ * The device does not acknowledge its address while a write cycle is running,
+ * so it is polled with empty write transactions until it answers.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @return I2C_OK once the device answers, I2C_ERROR_TIMEOUT after AT24C256_WRITE_TIMEOUT_MS.
  */
-void AT24C256_ReadPage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize) {
-    // Initiate a Start condition
-    I2C_Start();
-    // Write device address with RW bit set to 0 (write)
-    I2C_Write(eepromAddress);
-    // Write the high byte of the starting memory address (MSB)
-    I2C_Write(addressStart >> 8);
-    // Write the low byte of the starting memory address (LSB)
-    I2C_Write(addressStart & 0xFF);
-    // Re-initiate a Start condition
-    I2C_Start();
-    // Write device address with RW bit set to 1 (read)
-    I2C_Write(eepromAddress | 1);
-    // Read the page data
-    for (uint8_t i = 0; i < pageSize; i++) {
-        if (i < pageSize - 1) {
-            data[i] = I2C_ReadAck();
-        } else {
-            data[i] = I2C_ReadNack();
+uint8_t AT24C256_WaitReady(uint16_t eepromAddress) {
+    I2C_Transaction transaction;
+    AT24C256_InitTransaction(&transaction, eepromAddress, 0);
+    transaction.prefixLength = 0;  // Address only
+
+    for (uint8_t i = 0; i < AT24C256_WRITE_TIMEOUT_MS * 10; i++) {
+        uint8_t status = I2C_Transfer(&transaction);
+        if (status != I2C_ERROR_ADDRESS_NACK) return status;
+        _delay_us(100);
+    }
+    return I2C_ERROR_TIMEOUT;
+}
+
+/**
+ * @brief Writes bytes within one page of the AT24C256 EEPROM without waiting for the write cycle.
+ *
+ * The device ignores further accesses until its write cycle completes, so
+ * call AT24C256_WaitReady before the next one. Meanwhile the bus is free for
+ * other devices.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM where the data will be written.
+ * @param data Pointer to the data to be written.
+ * @param length The number of bytes to be written; they must not cross a page boundary.
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_StartWrite(uint16_t eepromAddress, uint16_t address, const uint8_t *data, uint8_t length) {
+    return AT24C256_Transfer(eepromAddress, address, data, length, NULL, 0);
+}
+
+/**
+ * @brief Writes any number of bytes to the AT24C256 EEPROM.
+ *
+ * The data is split at page boundaries and each page is written in a single
+ * transaction, followed by ACK polling so the next page starts as soon as the
+ * write cycle completes.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM where the data will be written.
+ * @param data Pointer to the data to be written.
+ * @param length The number of bytes to be written.
+ * @return I2C_OK, or the I2C error that ended the write; pages before the failing one are written.
+ */
+uint8_t AT24C256_Write(uint16_t eepromAddress, uint16_t address, const uint8_t *data, uint16_t length) {
+    while (length > 0) {
+        // Stop each transaction at the end of the page, where the device would wrap around
+        uint16_t chunk = AT24C256_PAGE_SIZE - (address & (AT24C256_PAGE_SIZE - 1));
+        if (chunk > length) chunk = length;
+
+        uint8_t status = AT24C256_StartWrite(eepromAddress, address, data, chunk);
+        if (status == I2C_OK) status = AT24C256_WaitReady(eepromAddress);
+        if (status != I2C_OK) return status;
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return I2C_OK;
+}
+
+/**
+ * @brief Reads any number of bytes from the AT24C256 EEPROM in one transaction.
+ *
+ * Waits for a pending write cycle with AT24C256_WaitReady, then streams the
+ * data using the device's address auto-increment. Reads past the last byte
+ * wrap around to address 0.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM from which the data will be read.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to be read, up to the 32768 bytes of the device.
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_Read(uint16_t eepromAddress, uint16_t address, uint8_t *data, uint16_t length) {
+    uint8_t status = AT24C256_WaitReady(eepromAddress);
+    if (status != I2C_OK) return status;
+    return AT24C256_Transfer(eepromAddress, address, NULL, 0, data, length);
+}
+
+/**
+ * @brief Reads any number of bytes from the AT24C256 EEPROM through a small buffer.
+ *
+ * Like AT24C256_Read, but the data is handed to a callback each time the
+ * buffer fills, and once more with the remaining bytes, so reading the whole
+ * device needs only bufferSize bytes of RAM.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM from which the data will be read.
+ * @param length The number of bytes to be read, up to the 32768 bytes of the device.
+ * @param buffer Buffer the chunks are read into.
+ * @param bufferSize The number of bytes in buffer, at least 1.
+ * @param callback Function receiving each chunk; the bus waits while it runs.
+ * @return I2C_OK, I2C_ERROR_INVALID if bufferSize is 0, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_ReadChunks(uint16_t eepromAddress, uint16_t address, uint16_t length, uint8_t *buffer,
+                            uint16_t bufferSize, AT24C256_ChunkCallback callback) {
+    if (bufferSize == 0) return I2C_ERROR_INVALID;
+
+    uint8_t status = AT24C256_WaitReady(eepromAddress);
+    if (status != I2C_OK) return status;
+
+    I2C_Transaction transaction;
+    AT24C256_InitTransaction(&transaction, eepromAddress, address);
+    transaction.readData = buffer;
+    transaction.readLength = length;
+    transaction.chunkCallback = callback;
+    transaction.chunkSize = bufferSize;
+    return I2C_Transfer(&transaction);
+}
+
+/**
+ * @brief Writes bytes to the AT24C256 EEPROM, skipping those it already holds.
+ *
+ * Each page of the target range is read first, and only the span from the
+ * first to the last differing byte is written, so pages holding the data
+ * already cost no write cycle and no endurance.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM where the data will be written.
+ * @param data Pointer to the data to be written.
+ * @param length The number of bytes to be written.
+ * @param skipped Receives the number of bytes that did not need writing, or NULL.
+ * @return I2C_OK, or the I2C error that ended the write.
+ */
+uint8_t AT24C256_WriteChanged(uint16_t eepromAddress, uint16_t address, const uint8_t *data, uint16_t length,
+                              uint16_t *skipped) {
+    uint8_t current[AT24C256_PAGE_SIZE];
+    uint16_t unchanged = 0;
+    uint8_t status = I2C_OK;
+
+    while (length > 0) {
+        uint8_t chunk = AT24C256_PAGE_SIZE - (address & (AT24C256_PAGE_SIZE - 1));
+        if (chunk > length) chunk = length;
+
+        status = AT24C256_Read(eepromAddress, address, current, chunk);
+        if (status != I2C_OK) break;
+
+        // Narrow the write to the span between the first and last differing bytes
+        uint8_t first = 0;
+        uint8_t end = chunk;
+        while (first < end && current[first] == data[first]) first++;
+        while (end > first && current[end - 1] == data[end - 1]) end--;
+
+        if (end > first) {
+            status = AT24C256_Write(eepromAddress, address + first, data + first, end - first);
+            if (status != I2C_OK) break;
         }
+        unchanged += chunk - (end - first);
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
     }
-    // Terminate the transmission
-    I2C_Stop();
+
+    if (skipped) *skipped = unchanged;
+    return status;
 }
@@ -3,6 +3,23 @@
 
 #include <stdint.h>
 
+/**
+ * @brief SCL frequency used for every transfer with the AT24C256, in Hz.
+ *
+ * Fast-mode rate the AT24C256 supports at 2.7 V and above.
+ */
+#define AT24C256_FREQUENCY 400000UL
+
+/**
+ * @brief Size of an AT24C256 write page, in bytes.
+ */
+#define AT24C256_PAGE_SIZE 64
+
+/**
+ * @brief Longest wait for an internal write cycle, in milliseconds (5 ms typical).
+ */
+#define AT24C256_WRITE_TIMEOUT_MS 10
+
 /**
  * @brief Writes a byte to the AT24C256 EEPROM.
  *
@@ -10,8 +27,9 @@
  * @param address The memory address within the EEPROM where the data will be
  * written.
  * @param data The byte of data to be written to the EEPROM.
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void AT24C256_WriteByte(uint16_t eepromAddress, uint16_t address, uint8_t data);
+uint8_t AT24C256_WriteByte(uint16_t eepromAddress, uint16_t address, uint8_t data);
 
 /**
  * @brief Reads a byte from the AT24C256 EEPROM.
@@ -32,8 +50,9 @@ uint8_t AT24C256_ReadByte(uint16_t eepromAddress, uint16_t address);
  * @param data Pointer to the data array where the read data will be stored.
  * @param pageSize The number of bytes to be read in one page (typically 64
  * bytes for AT24C256).
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void AT24C256_ReadPage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize);
+uint8_t AT24C256_ReadPage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize);
 
 /**
  * @brief Writes a page of data to the AT24C256 EEPROM.
@@ -43,8 +62,108 @@ void AT24C256_ReadPage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *d
  * data will be written.
  * @param data Pointer to the data array to be written.
  * @param pageSize The number of bytes to be written in one page (typically 64
- * bytes for AT24C256).
+ * bytes for AT24C256). Data crossing a page boundary continues on the next page.
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_WritePage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize);
+
+/**
+ * @brief Waits for the AT24C256 to finish its internal write cycle.
+ *
+ * The device does not acknowledge its address while a write cycle is running,
+ * so it is polled with empty write transactions until it answers.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @return I2C_OK once the device answers, I2C_ERROR_TIMEOUT after AT24C256_WRITE_TIMEOUT_MS.
+ */
+uint8_t AT24C256_WaitReady(uint16_t eepromAddress);
+
+/**
+ * @brief Writes bytes within one page of the AT24C256 EEPROM without waiting for the write cycle.
+ *
+ * The device ignores further accesses until its write cycle completes, so
+ * call AT24C256_WaitReady before the next one. Meanwhile the bus is free for
+ * other devices.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM where the data will be written.
+ * @param data Pointer to the data to be written.
+ * @param length The number of bytes to be written; they must not cross a page boundary.
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_StartWrite(uint16_t eepromAddress, uint16_t address, const uint8_t *data, uint8_t length);
+
+/**
+ * @brief Writes any number of bytes to the AT24C256 EEPROM.
+ *
+ * The data is split at page boundaries and each page is written in a single
+ * transaction, followed by ACK polling so the next page starts as soon as the
+ * write cycle completes.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM where the data will be written.
+ * @param data Pointer to the data to be written.
+ * @param length The number of bytes to be written.
+ * @return I2C_OK, or the I2C error that ended the write; pages before the failing one are written.
+ */
+uint8_t AT24C256_Write(uint16_t eepromAddress, uint16_t address, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Function receiving the data of AT24C256_ReadChunks.
+ *
+ * @param data The bytes read, in the caller's buffer.
+ * @param length Number of bytes in data.
+ */
+typedef void (*AT24C256_ChunkCallback)(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Reads any number of bytes from the AT24C256 EEPROM in one transaction.
+ *
+ * Waits for a pending write cycle with AT24C256_WaitReady, then streams the
+ * data using the device's address auto-increment. Reads past the last byte
+ * wrap around to address 0.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM from which the data will be read.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to be read, up to the 32768 bytes of the device.
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_Read(uint16_t eepromAddress, uint16_t address, uint8_t *data, uint16_t length);
+
+/**
+ * @brief Reads any number of bytes from the AT24C256 EEPROM through a small buffer.
+ *
+ * Like AT24C256_Read, but the data is handed to a callback each time the
+ * buffer fills, and once more with the remaining bytes, so reading the whole
+ * device needs only bufferSize bytes of RAM.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM from which the data will be read.
+ * @param length The number of bytes to be read, up to the 32768 bytes of the device.
+ * @param buffer Buffer the chunks are read into.
+ * @param bufferSize The number of bytes in buffer, at least 1.
+ * @param callback Function receiving each chunk; the bus waits while it runs.
+ * @return I2C_OK, I2C_ERROR_INVALID if bufferSize is 0, or the I2C error that ended the transfer.
+ */
+uint8_t AT24C256_ReadChunks(uint16_t eepromAddress, uint16_t address, uint16_t length, uint8_t *buffer,
+                            uint16_t bufferSize, AT24C256_ChunkCallback callback);
+
+/**
+ * @brief Writes bytes to the AT24C256 EEPROM, skipping those it already holds.
+ *
+ * Each page of the target range is read first, and only the span from the
+ * first to the last differing byte is written, so pages holding the data
+ * already cost no write cycle and no endurance.
+ *
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param address The memory address within the EEPROM where the data will be written.
+ * @param data Pointer to the data to be written.
+ * @param length The number of bytes to be written.
+ * @param skipped Receives the number of bytes that did not need writing, or NULL.
+ * @return I2C_OK, or the I2C error that ended the write.
  */
-void AT24C256_WritePage(uint16_t eepromAddress, uint16_t addressStart, uint8_t *data, uint8_t pageSize);
+uint8_t AT24C256_WriteChanged(uint16_t eepromAddress, uint16_t address, const uint8_t *data, uint16_t length,
+                              uint16_t *skipped);
 
 #endif  // AT24C256_H
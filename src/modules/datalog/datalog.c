@@ -0,0 +1,292 @@
+/*
+ * Include the header file for the ring-buffer data logger.
+ */
+#include "datalog.h"
+
+#include <string.h>
+#include <util/crc16.h>
+
+#include "../../protocols/i2c/i2c.h"
+#include "../../protocols/uart/uart.h"
+
+/*
+ * Offsets of the block fields.
+ */
+#define DATALOG_SEQUENCE 0
+#define DATALOG_LENGTH 4
+#define DATALOG_CRC (AT24C256_PAGE_SIZE - 2)
+
+/*
+ * @brief Sum of the payload bytes sent by DATALOG_Dump.
+ */
+static uint16_t DATALOG_sum;
+
+/*
+ * @brief Computes the CRC-CCITT of a block, everything but the CRC field.
+ *
+ * @param block The block.
+ * @return The CRC.
+ */
+static uint16_t DATALOG_Crc(const uint8_t *block) {
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < DATALOG_CRC; i++) {
+        crc = _crc_ccitt_update(crc, block[i]);
+    }
+    return crc;
+}
+
+/*
+ * @brief Reads a page and checks the block it holds.
+ *
+ * @param log The log.
+ * @param page The page, relative to the first page of the log.
+ * @param block Buffer of AT24C256_PAGE_SIZE bytes receiving the page.
+ * @param valid Receives 1 if the page holds an intact block, 0 otherwise.
+ * @return I2C_OK, or the I2C error of the read.
+ */
+static uint8_t DATALOG_ReadPage(DATALOG_Log *log, uint16_t page, uint8_t *block, uint8_t *valid) {
+    uint8_t status = AT24C256_Read(log->eepromAddress, (log->firstPage + page) * AT24C256_PAGE_SIZE, block,
+                                   AT24C256_PAGE_SIZE);
+    uint16_t crc = block[DATALOG_CRC] | (uint16_t)block[DATALOG_CRC + 1] << 8;
+    *valid = status == I2C_OK && block[DATALOG_LENGTH] <= DATALOG_PAYLOAD && crc == DATALOG_Crc(block);
+    return status;
+}
+
+/*
+ * @brief Gives the sequence number of a block.
+ *
+ * @param block The block.
+ * @return The sequence number.
+ */
+static uint32_t DATALOG_Sequence(const uint8_t *block) {
+    uint32_t sequence = 0;
+    for (uint8_t i = 4; i-- > 0;) {
+        sequence = (sequence << 8) | block[DATALOG_SEQUENCE + i];
+    }
+    return sequence;
+}
+
+/*
+ * @brief Mounts a log, locating its newest block by binary search.
+ *
+ * @param log The log to mount.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param firstPage The first page of the log.
+ * @param pageCount The number of pages of the log.
+ * @return DATALOG_OK, or the I2C error of a page read.
+ */
+uint8_t DATALOG_Mount(DATALOG_Log *log, uint16_t eepromAddress, uint16_t firstPage, uint16_t pageCount) {
+    log->eepromAddress = eepromAddress;
+    log->firstPage = firstPage;
+    log->pageCount = pageCount;
+    log->headPage = 0;
+    log->wrapped = 0;
+    log->sequence = 0;
+    log->buffer[DATALOG_LENGTH] = 0;
+
+    uint8_t block[AT24C256_PAGE_SIZE];
+    uint8_t valid;
+    uint8_t status = DATALOG_ReadPage(log, 0, block, &valid);
+    if (status != I2C_OK) return status;
+
+    if (!valid) {
+        // Either nothing was logged yet, or page 0 was torn while starting a new pass
+        status = DATALOG_ReadPage(log, pageCount - 1, block, &valid);
+        if (status != I2C_OK) return status;
+        if (valid) {
+            log->wrapped = 1;
+            log->sequence = DATALOG_Sequence(block) + 1;
+        }
+        return DATALOG_OK;
+    }
+
+    // Pages 0..newest hold consecutive sequence numbers from the one of page 0
+    uint32_t first = DATALOG_Sequence(block);
+    uint16_t newest = 0;
+    uint16_t high = pageCount - 1;
+    while (newest < high) {
+        uint16_t middle = newest + (high - newest + 1) / 2;
+        status = DATALOG_ReadPage(log, middle, block, &valid);
+        if (status != I2C_OK) return status;
+        if (valid && DATALOG_Sequence(block) == first + middle) {
+            newest = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    log->sequence = first + newest + 1;
+    log->headPage = newest + 1;
+    if (log->headPage == pageCount) {
+        log->headPage = 0;
+        log->wrapped = 1;
+    } else {
+        // The previous pass reached the last page if it holds the block before page 0
+        status = DATALOG_ReadPage(log, pageCount - 1, block, &valid);
+        if (status != I2C_OK) return status;
+        log->wrapped = valid && DATALOG_Sequence(block) + 1 == first;
+    }
+    return DATALOG_OK;
+}
+
+/*
+ * @brief Commits the block being filled, even if it is not full.
+ *
+ * @param log The log.
+ * @return DATALOG_OK, or the I2C error of the write; the block stays in SRAM on error.
+ *
+ * Use it before a planned power-down. The rest of the page stays unused.
+ */
+uint8_t DATALOG_Commit(DATALOG_Log *log) {
+    uint8_t *block = log->buffer;
+    if (block[DATALOG_LENGTH] == 0) return DATALOG_OK;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        block[DATALOG_SEQUENCE + i] = log->sequence >> (8 * i);
+    }
+    memset(&block[DATALOG_HEADER + block[DATALOG_LENGTH]], 0xFF, DATALOG_PAYLOAD - block[DATALOG_LENGTH]);
+    uint16_t crc = DATALOG_Crc(block);
+    block[DATALOG_CRC] = crc & 0xFF;
+    block[DATALOG_CRC + 1] = crc >> 8;
+
+    uint8_t status = AT24C256_Write(log->eepromAddress, (log->firstPage + log->headPage) * AT24C256_PAGE_SIZE, block,
+                                    AT24C256_PAGE_SIZE);
+    if (status != I2C_OK) return status;
+
+    log->sequence++;
+    if (++log->headPage == log->pageCount) {
+        log->headPage = 0;
+        log->wrapped = 1;
+    }
+    block[DATALOG_LENGTH] = 0;
+    return DATALOG_OK;
+}
+
+/*
+ * @brief Adds an entry to the block being filled, committing the block first if the entry does not fit.
+ *
+ * @param log The log.
+ * @param data The entry.
+ * @param length Length of the entry, up to DATALOG_PAYLOAD.
+ * @return DATALOG_OK, DATALOG_ERROR_SIZE, or the I2C error of the commit.
+ */
+uint8_t DATALOG_Append(DATALOG_Log *log, const uint8_t *data, uint8_t length) {
+    if (length > DATALOG_PAYLOAD) return DATALOG_ERROR_SIZE;
+
+    uint8_t used = log->buffer[DATALOG_LENGTH];
+    if (used + length > DATALOG_PAYLOAD) {
+        uint8_t status = DATALOG_Commit(log);
+        if (status != DATALOG_OK) return status;
+        used = 0;
+    }
+
+    memcpy(&log->buffer[DATALOG_HEADER + used], data, length);
+    log->buffer[DATALOG_LENGTH] = used + length;
+    return DATALOG_OK;
+}
+
+/*
+ * @brief Reads the log from the oldest block to the newest, then the block being filled.
+ *
+ * @param log The log.
+ * @param callback Function receiving each payload; blocks failing their CRC are skipped.
+ * @return DATALOG_OK, or the I2C error of a page read.
+ */
+uint8_t DATALOG_Read(DATALOG_Log *log, DATALOG_Callback callback) {
+    uint8_t block[AT24C256_PAGE_SIZE];
+    uint16_t page = log->wrapped ? log->headPage : 0;
+    uint16_t count = DATALOG_GetBlockCount(log);
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t valid;
+        uint8_t status = DATALOG_ReadPage(log, page, block, &valid);
+        if (status != I2C_OK) return status;
+        if (valid && block[DATALOG_LENGTH] > 0) callback(&block[DATALOG_HEADER], block[DATALOG_LENGTH]);
+        if (++page == log->pageCount) page = 0;
+    }
+
+    if (log->buffer[DATALOG_LENGTH] > 0) callback(&log->buffer[DATALOG_HEADER], log->buffer[DATALOG_LENGTH]);
+    return DATALOG_OK;
+}
+
+/*
+ * @brief Gives the payload of the block being filled, which is committed by the next DATALOG_Commit.
+ *
+ * @param log The log.
+ * @param length Receives the number of bytes in the payload, 0 if nothing is pending.
+ * @return The payload, inside the log's buffer.
+ */
+const uint8_t *DATALOG_GetPending(const DATALOG_Log *log, uint8_t *length) {
+    *length = log->buffer[DATALOG_LENGTH];
+    return &log->buffer[DATALOG_HEADER];
+}
+
+/*
+ * @brief Gives the number of committed blocks in the log.
+ *
+ * @param log The log.
+ * @return The number of blocks, including any that fail their CRC.
+ */
+uint16_t DATALOG_GetBlockCount(DATALOG_Log *log) { return log->wrapped ? log->pageCount : log->headPage; }
+
+/*
+ * @brief Reads one committed block by its position in the log.
+ *
+ * @param log The log.
+ * @param index The position of the block, 0 for the oldest.
+ * @param payload Buffer of DATALOG_PAYLOAD bytes receiving the payload.
+ * @param length Receives the number of bytes in the payload.
+ * @return DATALOG_OK, DATALOG_ERROR_CORRUPT if the block fails its CRC, or the I2C error of the read.
+ */
+uint8_t DATALOG_ReadBlock(DATALOG_Log *log, uint16_t index, uint8_t *payload, uint8_t *length) {
+    uint8_t block[AT24C256_PAGE_SIZE];
+    uint16_t page = log->wrapped ? (log->headPage + index) % log->pageCount : index;
+    uint8_t valid;
+    uint8_t status = DATALOG_ReadPage(log, page, block, &valid);
+    if (status != I2C_OK) return status;
+    if (!valid) return DATALOG_ERROR_CORRUPT;
+
+    *length = block[DATALOG_LENGTH];
+    memcpy(payload, &block[DATALOG_HEADER], *length);
+    return DATALOG_OK;
+}
+
+/*
+ * @brief Sends a payload over UART, preceded by its length.
+ *
+ * @param data The payload.
+ * @param length Number of bytes in the payload.
+ */
+static void DATALOG_SendPayload(const uint8_t *data, uint8_t length) {
+    UART_Transmit(length);
+    for (uint8_t i = 0; i < length; i++) {
+        UART_Transmit(data[i]);
+        DATALOG_sum += data[i];
+    }
+}
+
+/*
+ * @brief Sends the whole log over UART.
+ *
+ * @param log The log.
+ * @return DATALOG_OK, or the I2C error of a page read.
+ *
+ * The frame is "DLOG", then each payload preceded by its length byte, then a
+ * zero length byte and the 16-bit sum of the payload bytes, little-endian.
+ * UART_Init must have been called.
+ */
+uint8_t DATALOG_Dump(DATALOG_Log *log) {
+    UART_Transmit('D');
+    UART_Transmit('L');
+    UART_Transmit('O');
+    UART_Transmit('G');
+
+    DATALOG_sum = 0;
+    uint8_t status = DATALOG_Read(log, DATALOG_SendPayload);
+
+    // Close the frame even after a read error, so the receiver is not left waiting
+    UART_Transmit(0);
+    UART_Transmit(DATALOG_sum & 0xFF);
+    UART_Transmit(DATALOG_sum >> 8);
+    return status;
+}
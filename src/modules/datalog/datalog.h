@@ -0,0 +1,147 @@
+/*
+ * Header guard to prevent multiple inclusions of the "datalog.h" header file.
+ */
+#ifndef DATALOG_H
+#define DATALOG_H
+
+#include <stdint.h>
+
+#include "../at24c256/at24c256.h"
+
+/*
+ * Declarations of functions for the ring-buffer data logger.
+ *
+ * The log fills a range of AT24C256 pages in order and wraps around,
+ * overwriting the oldest page. Each page holds one block:
+ *
+ *     sequence (4 bytes) | length (1 byte) | payload (57 bytes) | CRC-CCITT (2 bytes)
+ *
+ * with multi-byte fields little-endian. Blocks are numbered in the order they
+ * are written, so within a pass over the range page i holds the sequence of
+ * page 0 plus i. Mounting uses that to binary-search the newest block in
+ * O(log pages) page reads. A block torn by a power failure fails its CRC and
+ * is skipped; every block committed before it stays readable.
+ *
+ * Entries are batched in SRAM and committed a whole page at a time, so the
+ * EEPROM sees one write cycle per page. An entry never spans two blocks.
+ */
+
+/*
+ * @brief Bytes of a block before the payload: sequence and length.
+ */
+#define DATALOG_HEADER 5
+
+/*
+ * @brief Payload bytes of a block, and the longest entry.
+ */
+#define DATALOG_PAYLOAD (AT24C256_PAGE_SIZE - DATALOG_HEADER - 2)
+
+/*
+ * Status codes besides I2C_OK and the I2C_ERROR_* codes.
+ */
+#define DATALOG_OK 0                // Same value as I2C_OK
+#define DATALOG_ERROR_SIZE 0x20     // Entry longer than DATALOG_PAYLOAD
+#define DATALOG_ERROR_CORRUPT 0x21  // The block read back failed its CRC
+
+/*
+ * @brief State of a log.
+ */
+typedef struct {
+    uint16_t eepromAddress;              // I2C address of the EEPROM device
+    uint16_t firstPage;                  // First page of the log
+    uint16_t pageCount;                  // Number of pages in the log
+    uint16_t headPage;                   // Page the next block is committed to, relative to firstPage
+    uint8_t wrapped;                     // 1 once every page holds a block, the oldest at headPage
+    uint32_t sequence;                   // Sequence number of the next block
+    uint8_t buffer[AT24C256_PAGE_SIZE];  // Block being filled
+} DATALOG_Log;
+
+/*
+ * @brief Function receiving the payload of each block.
+ *
+ * @param data The payload.
+ * @param length Number of bytes in the payload.
+ */
+typedef void (*DATALOG_Callback)(const uint8_t *data, uint8_t length);
+
+/*
+ * @brief Mounts a log, locating its newest block by binary search.
+ *
+ * @param log The log to mount.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param firstPage The first page of the log.
+ * @param pageCount The number of pages of the log.
+ * @return DATALOG_OK, or the I2C error of a page read.
+ */
+uint8_t DATALOG_Mount(DATALOG_Log *log, uint16_t eepromAddress, uint16_t firstPage, uint16_t pageCount);
+
+/*
+ * @brief Adds an entry to the block being filled, committing the block first if the entry does not fit.
+ *
+ * @param log The log.
+ * @param data The entry.
+ * @param length Length of the entry, up to DATALOG_PAYLOAD.
+ * @return DATALOG_OK, DATALOG_ERROR_SIZE, or the I2C error of the commit.
+ */
+uint8_t DATALOG_Append(DATALOG_Log *log, const uint8_t *data, uint8_t length);
+
+/*
+ * @brief Commits the block being filled, even if it is not full.
+ *
+ * @param log The log.
+ * @return DATALOG_OK, or the I2C error of the write; the block stays in SRAM on error.
+ *
+ * Use it before a planned power-down. The rest of the page stays unused.
+ */
+uint8_t DATALOG_Commit(DATALOG_Log *log);
+
+/*
+ * @brief Reads the log from the oldest block to the newest, then the block being filled.
+ *
+ * @param log The log.
+ * @param callback Function receiving each payload; blocks failing their CRC are skipped.
+ * @return DATALOG_OK, or the I2C error of a page read.
+ */
+uint8_t DATALOG_Read(DATALOG_Log *log, DATALOG_Callback callback);
+
+/*
+ * @brief Gives the payload of the block being filled, which is committed by the next DATALOG_Commit.
+ *
+ * @param log The log.
+ * @param length Receives the number of bytes in the payload, 0 if nothing is pending.
+ * @return The payload, inside the log's buffer.
+ */
+const uint8_t *DATALOG_GetPending(const DATALOG_Log *log, uint8_t *length);
+
+/*
+ * @brief Gives the number of committed blocks in the log.
+ *
+ * @param log The log.
+ * @return The number of blocks, including any that fail their CRC.
+ */
+uint16_t DATALOG_GetBlockCount(DATALOG_Log *log);
+
+/*
+ * @brief Reads one committed block by its position in the log.
+ *
+ * @param log The log.
+ * @param index The position of the block, 0 for the oldest.
+ * @param payload Buffer of DATALOG_PAYLOAD bytes receiving the payload.
+ * @param length Receives the number of bytes in the payload.
+ * @return DATALOG_OK, DATALOG_ERROR_CORRUPT if the block fails its CRC, or the I2C error of the read.
+ */
+uint8_t DATALOG_ReadBlock(DATALOG_Log *log, uint16_t index, uint8_t *payload, uint8_t *length);
+
+/*
+ * @brief Sends the whole log over UART.
+ *
+ * @param log The log.
+ * @return DATALOG_OK, or the I2C error of a page read.
+ *
+ * The frame is "DLOG", then each payload preceded by its length byte, then a
+ * zero length byte and the 16-bit sum of the payload bytes, little-endian.
+ * UART_Init must have been called.
+ */
+uint8_t DATALOG_Dump(DATALOG_Log *log);
+
+#endif  // DATALOG_H
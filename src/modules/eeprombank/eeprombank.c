@@ -0,0 +1,141 @@
+/*
+ * Include the header file for the AT24C256 bank.
+ */
+#include "eeprombank.h"
+
+#include "../../protocols/i2c/i2c.h"
+
+/*
+ * @brief Initializes a bank of chips at consecutive addresses from EEPROMBANK_BASE_ADDRESS.
+ *
+ * @param bank The bank to initialize.
+ * @param chipCount The number of chips, 1 to EEPROMBANK_MAX_CHIPS.
+ */
+void EEPROMBANK_Init(EEPROMBANK_Bank *bank, uint8_t chipCount) {
+    if (chipCount < 1) chipCount = 1;
+    if (chipCount > EEPROMBANK_MAX_CHIPS) chipCount = EEPROMBANK_MAX_CHIPS;
+    bank->chipCount = chipCount;
+    bank->busy = 0;
+}
+
+/*
+ * @brief Returns the size of the linear address space of a bank in bytes.
+ *
+ * @param bank The bank.
+ * @return The number of chips times EEPROMBANK_CHIP_SIZE.
+ */
+uint32_t EEPROMBANK_GetSize(const EEPROMBANK_Bank *bank) {
+    return bank->chipCount * EEPROMBANK_CHIP_SIZE;
+}
+
+/*
+ * @brief Locates the page segment that starts at a linear address.
+ *
+ * @param bank The bank.
+ * @param address The linear address.
+ * @param chip Receives the chip number.
+ * @param chipAddress Receives the address within the chip.
+ * @return The number of bytes from the address to the end of its page.
+ */
+static uint8_t EEPROMBANK_Locate(const EEPROMBANK_Bank *bank, uint32_t address, uint8_t *chip,
+                                 uint16_t *chipAddress) {
+    uint16_t page = address / AT24C256_PAGE_SIZE;
+    uint8_t offset = address & (AT24C256_PAGE_SIZE - 1);
+    *chip = page % bank->chipCount;
+    *chipAddress = (page / bank->chipCount) * AT24C256_PAGE_SIZE + offset;
+    return AT24C256_PAGE_SIZE - offset;
+}
+
+/*
+ * @brief Checks that an access lies within the bank.
+ *
+ * @param bank The bank.
+ * @param address The linear address of the first byte.
+ * @param length The number of bytes.
+ * @return 1 if every byte exists, 0 otherwise.
+ */
+static uint8_t EEPROMBANK_Fits(const EEPROMBANK_Bank *bank, uint32_t address, uint16_t length) {
+    uint32_t size = EEPROMBANK_GetSize(bank);
+    return address <= size && length <= size - address;
+}
+
+/*
+ * @brief Reads bytes from the linear address space.
+ *
+ * @param bank The bank.
+ * @param address The linear address to read from.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to read.
+ * @return I2C_OK, EEPROMBANK_ERROR_RANGE, or the I2C error that ended the transfer.
+ */
+uint8_t EEPROMBANK_Read(EEPROMBANK_Bank *bank, uint32_t address, uint8_t *data, uint16_t length) {
+    if (!EEPROMBANK_Fits(bank, address, length)) return EEPROMBANK_ERROR_RANGE;
+
+    while (length > 0) {
+        uint8_t chip;
+        uint16_t chipAddress;
+        uint16_t chunk = EEPROMBANK_Locate(bank, address, &chip, &chipAddress);
+        if (chunk > length) chunk = length;
+
+        // AT24C256_Read waits for the write cycle, so the chip is idle afterwards
+        uint8_t status = AT24C256_Read(EEPROMBANK_BASE_ADDRESS + (chip << 1), chipAddress, data, chunk);
+        if (status != I2C_OK) return status;
+        bank->busy &= ~(1 << chip);
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return I2C_OK;
+}
+
+/*
+ * @brief Writes bytes to the linear address space, overlapping the write cycles of different chips.
+ *
+ * @param bank The bank.
+ * @param address The linear address to write to.
+ * @param data Pointer to the data to write.
+ * @param length The number of bytes to write.
+ * @return I2C_OK, EEPROMBANK_ERROR_RANGE, or the I2C error that ended the transfer.
+ *
+ * The last pages may still be in their write cycle on return.
+ */
+uint8_t EEPROMBANK_Write(EEPROMBANK_Bank *bank, uint32_t address, const uint8_t *data, uint16_t length) {
+    if (!EEPROMBANK_Fits(bank, address, length)) return EEPROMBANK_ERROR_RANGE;
+
+    while (length > 0) {
+        uint8_t chip;
+        uint16_t chipAddress;
+        uint16_t chunk = EEPROMBANK_Locate(bank, address, &chip, &chipAddress);
+        if (chunk > length) chunk = length;
+
+        uint16_t eepromAddress = EEPROMBANK_BASE_ADDRESS + (chip << 1);
+        uint8_t status = I2C_OK;
+        if (bank->busy & (1 << chip)) status = AT24C256_WaitReady(eepromAddress);
+        if (status == I2C_OK) status = AT24C256_StartWrite(eepromAddress, chipAddress, data, chunk);
+        if (status != I2C_OK) return status;
+        bank->busy |= 1 << chip;
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return I2C_OK;
+}
+
+/*
+ * @brief Waits until every chip has finished its write cycle.
+ *
+ * @param bank The bank.
+ * @return I2C_OK, or I2C_ERROR_TIMEOUT if a chip never acknowledged.
+ */
+uint8_t EEPROMBANK_Sync(EEPROMBANK_Bank *bank) {
+    for (uint8_t chip = 0; chip < bank->chipCount; chip++) {
+        if (!(bank->busy & (1 << chip))) continue;
+
+        uint8_t status = AT24C256_WaitReady(EEPROMBANK_BASE_ADDRESS + (chip << 1));
+        if (status != I2C_OK) return status;
+        bank->busy &= ~(1 << chip);
+    }
+    return I2C_OK;
+}
@@ -0,0 +1,102 @@
+/*
+ * Header guard to prevent multiple inclusions of the "eeprombank.h" header file.
+ */
+#ifndef EEPROMBANK_H
+#define EEPROMBANK_H
+
+#include <stdint.h>
+
+#include "../at24c256/at24c256.h"
+
+/*
+ * Declarations of functions for a bank of AT24C256 EEPROMs sharing the I2C bus.
+ *
+ * Up to eight chips, strapped to consecutive device addresses starting at
+ * EEPROMBANK_BASE_ADDRESS, form one linear address space of up to 256 KiB
+ * (18 bits). Pages are interleaved across the chips: linear page p lives in
+ * page p / chipCount of chip p % chipCount. A sequential write therefore
+ * moves to another chip after every page and sends the next page while the
+ * previous chip is still in its write cycle; a chip is only ACK-polled when
+ * the bank comes back to it. With enough chips to cover the write cycle, the
+ * write throughput is limited by the bus instead of the EEPROMs.
+ *
+ * Writes return before the last pages finish their write cycle. Reads wait
+ * for a busy chip by themselves; call EEPROMBANK_Sync before the power may
+ * go away.
+ */
+
+/*
+ * @brief I2C address of the chip with all address pins low; chip n answers at EEPROMBANK_BASE_ADDRESS + 2n.
+ */
+#define EEPROMBANK_BASE_ADDRESS 0xA0
+
+/*
+ * @brief Largest number of chips on one bus.
+ */
+#define EEPROMBANK_MAX_CHIPS 8
+
+/*
+ * @brief Size of one chip in bytes.
+ */
+#define EEPROMBANK_CHIP_SIZE 32768UL
+
+// Status codes besides the I2C ones
+#define EEPROMBANK_ERROR_RANGE 0x40  // The access does not fit in the bank
+
+/*
+ * @brief State of a bank of EEPROMs.
+ */
+typedef struct {
+    uint8_t chipCount;  // Number of chips, 1 to EEPROMBANK_MAX_CHIPS
+    uint8_t busy;       // Bit n is set while chip n may be in a write cycle
+} EEPROMBANK_Bank;
+
+/*
+ * @brief Initializes a bank of chips at consecutive addresses from EEPROMBANK_BASE_ADDRESS.
+ *
+ * @param bank The bank to initialize.
+ * @param chipCount The number of chips, 1 to EEPROMBANK_MAX_CHIPS.
+ */
+void EEPROMBANK_Init(EEPROMBANK_Bank *bank, uint8_t chipCount);
+
+/*
+ * @brief Returns the size of the linear address space of a bank in bytes.
+ *
+ * @param bank The bank.
+ * @return The number of chips times EEPROMBANK_CHIP_SIZE.
+ */
+uint32_t EEPROMBANK_GetSize(const EEPROMBANK_Bank *bank);
+
+/*
+ * @brief Reads bytes from the linear address space.
+ *
+ * @param bank The bank.
+ * @param address The linear address to read from.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to read.
+ * @return I2C_OK, EEPROMBANK_ERROR_RANGE, or the I2C error that ended the transfer.
+ */
+uint8_t EEPROMBANK_Read(EEPROMBANK_Bank *bank, uint32_t address, uint8_t *data, uint16_t length);
+
+/*
+ * @brief Writes bytes to the linear address space, overlapping the write cycles of different chips.
+ *
+ * @param bank The bank.
+ * @param address The linear address to write to.
+ * @param data Pointer to the data to write.
+ * @param length The number of bytes to write.
+ * @return I2C_OK, EEPROMBANK_ERROR_RANGE, or the I2C error that ended the transfer.
+ *
+ * The last pages may still be in their write cycle on return.
+ */
+uint8_t EEPROMBANK_Write(EEPROMBANK_Bank *bank, uint32_t address, const uint8_t *data, uint16_t length);
+
+/*
+ * @brief Waits until every chip has finished its write cycle.
+ *
+ * @param bank The bank.
+ * @return I2C_OK, or I2C_ERROR_TIMEOUT if a chip never acknowledged.
+ */
+uint8_t EEPROMBANK_Sync(EEPROMBANK_Bank *bank);
+
+#endif  // EEPROMBANK_H
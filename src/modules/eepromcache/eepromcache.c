@@ -0,0 +1,200 @@
+/*
+ * Include the header file for the AT24C256 page cache.
+ */
+#include "eepromcache.h"
+
+#include <string.h>
+
+#include "../../protocols/i2c/i2c.h"
+
+/*
+ * @brief Initializes an empty cache in front of an EEPROM.
+ *
+ * @param cache The cache to initialize.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ */
+void EEPROMCACHE_Init(EEPROMCACHE_Cache *cache, uint16_t eepromAddress) {
+    cache->eepromAddress = eepromAddress;
+    for (uint8_t i = 0; i < EEPROMCACHE_WAYS; i++) {
+        cache->lines[i].page = EEPROMCACHE_EMPTY;
+        cache->lines[i].dirtyEnd = 0;
+        cache->lines[i].age = 0xFF;
+    }
+    memset(&cache->stats, 0, sizeof(cache->stats));
+}
+
+/*
+ * @brief Writes the dirty range of a line back to the EEPROM.
+ *
+ * @param cache The cache.
+ * @param line The line to write back; nothing is written if it is clean.
+ * @return I2C_OK, or the I2C error of the write; the line stays dirty on error.
+ */
+static uint8_t EEPROMCACHE_Flush(EEPROMCACHE_Cache *cache, EEPROMCACHE_Line *line) {
+    if (line->dirtyEnd == 0) return I2C_OK;
+
+    uint8_t status = AT24C256_Write(cache->eepromAddress, line->page * AT24C256_PAGE_SIZE + line->dirtyStart,
+                                    &line->data[line->dirtyStart], line->dirtyEnd - line->dirtyStart);
+    if (status == I2C_OK) {
+        line->dirtyEnd = 0;
+        cache->stats.flushes++;
+    }
+    return status;
+}
+
+/*
+ * @brief Finds the line holding a page, loading the page into the least recently used line on a miss.
+ *
+ * @param cache The cache.
+ * @param page The page number.
+ * @param load 0 if the caller overwrites the whole page, so its contents need not be read.
+ * @param line Receives the line holding the page.
+ * @return I2C_OK, or the I2C error of the write-back or load.
+ */
+static uint8_t EEPROMCACHE_Fetch(EEPROMCACHE_Cache *cache, uint16_t page, uint8_t load, EEPROMCACHE_Line **line) {
+    EEPROMCACHE_Line *found = NULL;
+    EEPROMCACHE_Line *victim = &cache->lines[0];
+    for (uint8_t i = 0; i < EEPROMCACHE_WAYS; i++) {
+        EEPROMCACHE_Line *candidate = &cache->lines[i];
+        if (candidate->page == page) found = candidate;
+        if (candidate->age > victim->age) victim = candidate;
+    }
+
+    if (found) {
+        cache->stats.hits++;
+    } else {
+        cache->stats.misses++;
+        uint8_t status = EEPROMCACHE_Flush(cache, victim);
+        if (status != I2C_OK) return status;
+
+        victim->page = EEPROMCACHE_EMPTY;
+        if (load) {
+            status = AT24C256_Read(cache->eepromAddress, page * AT24C256_PAGE_SIZE, victim->data, AT24C256_PAGE_SIZE);
+            if (status != I2C_OK) return status;
+        }
+        victim->page = page;
+        found = victim;
+    }
+
+    // Age every other line, so the least recently used one has the largest age
+    for (uint8_t i = 0; i < EEPROMCACHE_WAYS; i++) {
+        if (cache->lines[i].age < 0xFF) cache->lines[i].age++;
+    }
+    found->age = 0;
+
+    *line = found;
+    return I2C_OK;
+}
+
+/*
+ * @brief Reads bytes through the cache.
+ *
+ * @param cache The cache.
+ * @param address The memory address within the EEPROM to read from.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to read.
+ * @return I2C_OK, or the I2C error of a page load or write-back.
+ */
+uint8_t EEPROMCACHE_Read(EEPROMCACHE_Cache *cache, uint16_t address, uint8_t *data, uint16_t length) {
+    while (length > 0) {
+        uint8_t offset = address & (AT24C256_PAGE_SIZE - 1);
+        uint16_t chunk = AT24C256_PAGE_SIZE - offset;
+        if (chunk > length) chunk = length;
+
+        EEPROMCACHE_Line *line;
+        uint8_t status = EEPROMCACHE_Fetch(cache, address / AT24C256_PAGE_SIZE, 1, &line);
+        if (status != I2C_OK) return status;
+        memcpy(data, &line->data[offset], chunk);
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return I2C_OK;
+}
+
+/*
+ * @brief Writes bytes into the cache; they reach the EEPROM when their page is flushed.
+ *
+ * @param cache The cache.
+ * @param address The memory address within the EEPROM to write to.
+ * @param data Pointer to the data to write.
+ * @param length The number of bytes to write.
+ * @return I2C_OK, or the I2C error of a page load or write-back.
+ */
+uint8_t EEPROMCACHE_Write(EEPROMCACHE_Cache *cache, uint16_t address, const uint8_t *data, uint16_t length) {
+    while (length > 0) {
+        uint8_t offset = address & (AT24C256_PAGE_SIZE - 1);
+        uint16_t chunk = AT24C256_PAGE_SIZE - offset;
+        if (chunk > length) chunk = length;
+
+        // A write covering the whole page does not need the old contents
+        EEPROMCACHE_Line *line;
+        uint8_t status = EEPROMCACHE_Fetch(cache, address / AT24C256_PAGE_SIZE, chunk < AT24C256_PAGE_SIZE, &line);
+        if (status != I2C_OK) return status;
+        memcpy(&line->data[offset], data, chunk);
+
+        // Grow the dirty range to cover the bytes just written
+        if (line->dirtyEnd == 0) {
+            line->dirtyStart = offset;
+            line->dirtyEnd = offset + chunk;
+            line->dirtyAge = 0;
+        } else {
+            if (offset < line->dirtyStart) line->dirtyStart = offset;
+            if (offset + chunk > line->dirtyEnd) line->dirtyEnd = offset + chunk;
+        }
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return I2C_OK;
+}
+
+/*
+ * @brief Writes every dirty page back to the EEPROM.
+ *
+ * @param cache The cache.
+ * @return I2C_OK, or the I2C error of the first page that failed; failed pages stay dirty.
+ */
+uint8_t EEPROMCACHE_Sync(EEPROMCACHE_Cache *cache) {
+    uint8_t result = I2C_OK;
+    for (uint8_t i = 0; i < EEPROMCACHE_WAYS; i++) {
+        uint8_t status = EEPROMCACHE_Flush(cache, &cache->lines[i]);
+        if (result == I2C_OK) result = status;
+    }
+    return result;
+}
+
+/*
+ * @brief Ages dirty pages and writes back those dirty for EEPROMCACHE_FLUSH_MS; call once per millisecond.
+ *
+ * @param cache The cache.
+ * @return I2C_OK, or the I2C error of a write-back.
+ *
+ * Write-backs use the blocking I2C functions, so call it from the main loop,
+ * not from the timer interrupt.
+ */
+uint8_t EEPROMCACHE_Tick(EEPROMCACHE_Cache *cache) {
+    uint8_t result = I2C_OK;
+    for (uint8_t i = 0; i < EEPROMCACHE_WAYS; i++) {
+        EEPROMCACHE_Line *line = &cache->lines[i];
+        if (line->dirtyEnd == 0) continue;
+        if (++line->dirtyAge < EEPROMCACHE_FLUSH_MS) continue;
+
+        uint8_t status = EEPROMCACHE_Flush(cache, line);
+        if (result == I2C_OK) result = status;
+    }
+    return result;
+}
+
+/*
+ * @brief Copies the counters and clears them.
+ *
+ * @param cache The cache.
+ * @param stats Receives the counters since the last call.
+ */
+void EEPROMCACHE_TakeStats(EEPROMCACHE_Cache *cache, EEPROMCACHE_Stats *stats) {
+    *stats = cache->stats;
+    memset(&cache->stats, 0, sizeof(cache->stats));
+}
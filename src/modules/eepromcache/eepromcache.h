@@ -0,0 +1,130 @@
+/*
+ * Header guard to prevent multiple inclusions of the "eepromcache.h" header file.
+ */
+#ifndef EEPROMCACHE_H
+#define EEPROMCACHE_H
+
+#include <stdint.h>
+
+#include "../at24c256/at24c256.h"
+
+/*
+ * Declarations of functions for the AT24C256 page cache.
+ *
+ * The cache keeps a few EEPROM pages in SRAM. Reads of a cached page cost no
+ * bus traffic, and writes only update the copy in SRAM and mark it dirty, so
+ * repeated updates of the same page cost a single write cycle. Dirty pages are
+ * written back when they are evicted, on EEPROMCACHE_Sync, or once they have
+ * been dirty for EEPROMCACHE_FLUSH_MS as counted by EEPROMCACHE_Tick. Only the
+ * dirty byte range of a page is written back.
+ *
+ * Data written through the cache is lost on reset until it is flushed.
+ */
+
+/*
+ * @brief Number of pages held by a cache; each costs AT24C256_PAGE_SIZE bytes of SRAM.
+ */
+#ifndef EEPROMCACHE_WAYS
+#define EEPROMCACHE_WAYS 2
+#endif
+
+/*
+ * @brief Longest time a page stays dirty before EEPROMCACHE_Tick writes it back, in milliseconds.
+ */
+#ifndef EEPROMCACHE_FLUSH_MS
+#define EEPROMCACHE_FLUSH_MS 1000
+#endif
+
+/*
+ * @brief Page number of a cache line that holds no page.
+ */
+#define EEPROMCACHE_EMPTY 0xFFFF
+
+/*
+ * @brief A cached EEPROM page.
+ */
+typedef struct {
+    uint16_t page;                     // Page number, or EEPROMCACHE_EMPTY
+    uint8_t dirtyStart;                // First byte changed since the last write-back
+    uint8_t dirtyEnd;                  // One past the last changed byte, 0 if the page is clean
+    uint16_t dirtyAge;                 // Milliseconds since the page became dirty
+    uint8_t age;                       // Accesses to other lines since this one was used
+    uint8_t data[AT24C256_PAGE_SIZE];  // Page contents
+} EEPROMCACHE_Line;
+
+/*
+ * @brief Access counters of a cache.
+ */
+typedef struct {
+    uint32_t hits;     // Page accesses served from SRAM
+    uint16_t misses;   // Page accesses that loaded or allocated a line
+    uint16_t flushes;  // Pages written back to the EEPROM
+} EEPROMCACHE_Stats;
+
+/*
+ * @brief State of a page cache.
+ */
+typedef struct {
+    uint16_t eepromAddress;                    // I2C address of the EEPROM device
+    EEPROMCACHE_Line lines[EEPROMCACHE_WAYS];  // Cached pages
+    EEPROMCACHE_Stats stats;                   // Counters since the last EEPROMCACHE_TakeStats
+} EEPROMCACHE_Cache;
+
+/*
+ * @brief Initializes an empty cache in front of an EEPROM.
+ *
+ * @param cache The cache to initialize.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ */
+void EEPROMCACHE_Init(EEPROMCACHE_Cache *cache, uint16_t eepromAddress);
+
+/*
+ * @brief Reads bytes through the cache.
+ *
+ * @param cache The cache.
+ * @param address The memory address within the EEPROM to read from.
+ * @param data Pointer to the buffer where the read data will be stored.
+ * @param length The number of bytes to read.
+ * @return I2C_OK, or the I2C error of a page load or write-back.
+ */
+uint8_t EEPROMCACHE_Read(EEPROMCACHE_Cache *cache, uint16_t address, uint8_t *data, uint16_t length);
+
+/*
+ * @brief Writes bytes into the cache; they reach the EEPROM when their page is flushed.
+ *
+ * @param cache The cache.
+ * @param address The memory address within the EEPROM to write to.
+ * @param data Pointer to the data to write.
+ * @param length The number of bytes to write.
+ * @return I2C_OK, or the I2C error of a page load or write-back.
+ */
+uint8_t EEPROMCACHE_Write(EEPROMCACHE_Cache *cache, uint16_t address, const uint8_t *data, uint16_t length);
+
+/*
+ * @brief Writes every dirty page back to the EEPROM.
+ *
+ * @param cache The cache.
+ * @return I2C_OK, or the I2C error of the first page that failed; failed pages stay dirty.
+ */
+uint8_t EEPROMCACHE_Sync(EEPROMCACHE_Cache *cache);
+
+/*
+ * @brief Ages dirty pages and writes back those dirty for EEPROMCACHE_FLUSH_MS; call once per millisecond.
+ *
+ * @param cache The cache.
+ * @return I2C_OK, or the I2C error of a write-back.
+ *
+ * Write-backs use the blocking I2C functions, so call it from the main loop,
+ * not from the timer interrupt.
+ */
+uint8_t EEPROMCACHE_Tick(EEPROMCACHE_Cache *cache);
+
+/*
+ * @brief Copies the counters and clears them.
+ *
+ * @param cache The cache.
+ * @param stats Receives the counters since the last call.
+ */
+void EEPROMCACHE_TakeStats(EEPROMCACHE_Cache *cache, EEPROMCACHE_Stats *stats);
+
+#endif  // EEPROMCACHE_H
@@ -0,0 +1,336 @@
+/*
+ * Include the header file for the log-structured key-value store.
+ */
+#include "kvstore.h"
+
+#include <string.h>
+#include <util/crc16.h>
+
+#include "../../protocols/i2c/i2c.h"
+
+/*
+ * Offsets of the record fields.
+ */
+#define KVSTORE_SEQUENCE 0
+#define KVSTORE_KEY 4
+#define KVSTORE_LENGTH 6
+#define KVSTORE_VALUE 7
+
+/*
+ * @brief Computes the CRC-CCITT of a block.
+ *
+ * @param data The block.
+ * @param length The number of bytes in the block.
+ * @return The CRC.
+ */
+static uint16_t KVSTORE_Crc(const uint8_t *data, uint8_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < length; i++) {
+        crc = _crc_ccitt_update(crc, data[i]);
+    }
+    return crc;
+}
+
+/*
+ * @brief Reads a little-endian field of a record.
+ *
+ * @param data The first byte of the field.
+ * @param size The size of the field in bytes.
+ * @return The field value.
+ */
+static uint32_t KVSTORE_Field(const uint8_t *data, uint8_t size) {
+    uint32_t value = 0;
+    while (size-- > 0) {
+        value = (value << 8) | data[size];
+    }
+    return value;
+}
+
+/*
+ * @brief Checks the record at an offset of a page.
+ *
+ * @param page The page contents.
+ * @param offset The offset of the record.
+ * @return The size of the record, or 0 if there is no valid record at the offset.
+ */
+static uint8_t KVSTORE_ParseRecord(const uint8_t *page, uint8_t offset) {
+    if (offset + KVSTORE_RECORD_OVERHEAD > AT24C256_PAGE_SIZE) return 0;
+
+    const uint8_t *record = page + offset;
+    uint8_t size = record[KVSTORE_LENGTH] + KVSTORE_RECORD_OVERHEAD;
+    if (record[KVSTORE_LENGTH] > KVSTORE_MAX_VALUE || offset + size > AT24C256_PAGE_SIZE) return 0;
+
+    uint16_t crc = KVSTORE_Crc(record, size - 2);
+    return KVSTORE_Field(record + size - 2, 2) == crc ? size : 0;
+}
+
+/*
+ * @brief Finds the index entry of a key.
+ *
+ * @param store The store.
+ * @param key The key.
+ * @param insert 1 to return a free entry when the key is absent, 0 to return NULL.
+ * @return The entry, a free entry for the key, or NULL.
+ */
+static KVSTORE_Entry *KVSTORE_Find(KVSTORE_Store *store, uint16_t key, uint8_t insert) {
+    uint8_t slot = (key ^ (key >> 5) ^ (key >> 11)) & (KVSTORE_INDEX_SIZE - 1);
+    for (uint8_t i = 0; i < KVSTORE_INDEX_SIZE; i++) {
+        KVSTORE_Entry *entry = &store->index[slot];
+        if (entry->key == key) return entry;
+        if (entry->key == KVSTORE_NO_KEY) return insert ? entry : NULL;
+        slot = (slot + 1) & (KVSTORE_INDEX_SIZE - 1);
+    }
+    return NULL;
+}
+
+/*
+ * @brief Gives the page of an EEPROM address, relative to the first page of the log.
+ *
+ * @param store The store.
+ * @param address The EEPROM address.
+ * @return The page.
+ */
+static inline uint16_t KVSTORE_PageOf(KVSTORE_Store *store, uint16_t address) {
+    return address / AT24C256_PAGE_SIZE - store->firstPage;
+}
+
+/*
+ * @brief Reads a page of the log.
+ *
+ * @param store The store.
+ * @param page The page, relative to the first page of the log.
+ * @param data Buffer of AT24C256_PAGE_SIZE bytes.
+ * @return I2C_OK, or the I2C error of the read.
+ */
+static uint8_t KVSTORE_ReadPage(KVSTORE_Store *store, uint16_t page, uint8_t *data) {
+    return AT24C256_Read(store->eepromAddress, (store->firstPage + page) * AT24C256_PAGE_SIZE, data,
+                         AT24C256_PAGE_SIZE);
+}
+
+/*
+ * @brief Counts the pages after the head page that hold no live record.
+ *
+ * @param store The store.
+ */
+static void KVSTORE_UpdateFreePages(KVSTORE_Store *store) {
+    // The oldest live page is the first one reached going forward from the head
+    uint16_t free = store->pageCount - 1;
+    for (uint8_t i = 0; i < KVSTORE_INDEX_SIZE; i++) {
+        if (store->index[i].key == KVSTORE_NO_KEY) continue;
+        uint16_t page = KVSTORE_PageOf(store, store->index[i].address);
+        uint16_t distance = (page + store->pageCount - store->headPage - 1) % store->pageCount;
+        if (distance < free) free = distance;
+    }
+    store->freePages = free;
+}
+
+/*
+ * @brief Appends a record at the head of the log and points the key's index entry at it.
+ *
+ * @param store The store.
+ * @param key The key; it must have an index entry or a free one.
+ * @param value The value.
+ * @param length The length of the value.
+ * @return KVSTORE_OK, KVSTORE_ERROR_FULL if a new page is needed and none is free, or an I2C error.
+ */
+static uint8_t KVSTORE_Append(KVSTORE_Store *store, uint16_t key, const uint8_t *value, uint8_t length) {
+    uint8_t record[AT24C256_PAGE_SIZE];
+    uint8_t size = length + KVSTORE_RECORD_OVERHEAD;
+
+    if (store->headOffset + size > AT24C256_PAGE_SIZE) {
+        // Leave the rest of the page; the next page must hold no live record
+        if (store->freePages == 0) return KVSTORE_ERROR_FULL;
+        store->headPage = (store->headPage + 1) % store->pageCount;
+        store->headOffset = 0;
+        store->freePages--;
+    }
+
+    uint32_t sequence = store->sequence;
+    for (uint8_t i = 0; i < 4; i++) {
+        record[KVSTORE_SEQUENCE + i] = sequence >> (8 * i);
+    }
+    record[KVSTORE_KEY] = key & 0xFF;
+    record[KVSTORE_KEY + 1] = key >> 8;
+    record[KVSTORE_LENGTH] = length;
+    memcpy(&record[KVSTORE_VALUE], value, length);
+    uint16_t crc = KVSTORE_Crc(record, size - 2);
+    record[size - 2] = crc & 0xFF;
+    record[size - 1] = crc >> 8;
+
+    uint16_t address = (store->firstPage + store->headPage) * AT24C256_PAGE_SIZE + store->headOffset;
+    uint8_t status = AT24C256_Write(store->eepromAddress, address, record, size);
+    if (status != I2C_OK) return status;
+
+    KVSTORE_Entry *entry = KVSTORE_Find(store, key, 1);
+    entry->key = key;
+    entry->address = address;
+    entry->sequence = sequence;
+
+    store->sequence++;
+    store->headOffset += size;
+    KVSTORE_UpdateFreePages(store);
+    return KVSTORE_OK;
+}
+
+/*
+ * @brief Copies the live records of the oldest page to the head, freeing that page.
+ *
+ * @param store The store.
+ * @return KVSTORE_OK, or the error of a read or append.
+ */
+static uint8_t KVSTORE_CompactPage(KVSTORE_Store *store) {
+    if (store->freePages >= store->pageCount - 1) return KVSTORE_OK;  // Only the head page is in use
+
+    uint8_t data[AT24C256_PAGE_SIZE];
+    uint16_t page = (store->headPage + 1 + store->freePages) % store->pageCount;
+    uint8_t status = KVSTORE_ReadPage(store, page, data);
+    if (status != I2C_OK) return status;
+
+    uint16_t pageAddress = (store->firstPage + page) * AT24C256_PAGE_SIZE;
+    uint8_t offset = 0;
+    uint8_t size;
+    while ((size = KVSTORE_ParseRecord(data, offset)) != 0) {
+        // Move the record only if the index still points at it
+        const uint8_t *record = data + offset;
+        KVSTORE_Entry *entry = KVSTORE_Find(store, KVSTORE_Field(record + KVSTORE_KEY, 2), 0);
+        if (entry && entry->address == pageAddress + offset) {
+            status = KVSTORE_Append(store, entry->key, record + KVSTORE_VALUE, record[KVSTORE_LENGTH]);
+            if (status != KVSTORE_OK) return status;
+        }
+        offset += size;
+    }
+    return KVSTORE_OK;
+}
+
+/*
+ * @brief Mounts a store, rebuilding its index from the records in EEPROM.
+ *
+ * @param store The store to mount.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param firstPage The first page of the log.
+ * @param pageCount The number of pages of the log, at least KVSTORE_RESERVE_PAGES + 2.
+ * @return KVSTORE_OK, KVSTORE_ERROR_FULL if the log holds more keys than KVSTORE_INDEX_SIZE, or the I2C error
+ *         of a page read.
+ *
+ * Reads every page of the log once. A blank or foreign range mounts as an
+ * empty store. A store that fails to mount must not be written, since the
+ * pages of the keys left out of the index would count as free.
+ */
+uint8_t KVSTORE_Mount(KVSTORE_Store *store, uint16_t eepromAddress, uint16_t firstPage, uint16_t pageCount) {
+    store->eepromAddress = eepromAddress;
+    store->firstPage = firstPage;
+    store->pageCount = pageCount;
+    store->headPage = 0;
+    store->headOffset = 0;
+    store->sequence = 0;
+    for (uint8_t i = 0; i < KVSTORE_INDEX_SIZE; i++) {
+        store->index[i].key = KVSTORE_NO_KEY;
+    }
+
+    uint8_t data[AT24C256_PAGE_SIZE];
+    uint8_t found = 0;
+    for (uint16_t page = 0; page < pageCount; page++) {
+        uint8_t status = KVSTORE_ReadPage(store, page, data);
+        if (status != I2C_OK) return status;
+
+        uint8_t offset = 0;
+        uint8_t size;
+        uint32_t previous = 0;
+        while ((size = KVSTORE_ParseRecord(data, offset)) != 0) {
+            const uint8_t *record = data + offset;
+            uint32_t sequence = KVSTORE_Field(record + KVSTORE_SEQUENCE, 4);
+            uint16_t key = KVSTORE_Field(record + KVSTORE_KEY, 2);
+            if (offset > 0 && sequence <= previous) break;  // Stale record behind the page's newest ones
+            previous = sequence;
+
+            // Keep the newest record of each key
+            KVSTORE_Entry *entry = key == KVSTORE_NO_KEY ? NULL : KVSTORE_Find(store, key, 1);
+            if (key != KVSTORE_NO_KEY && !entry) return KVSTORE_ERROR_FULL;
+            if (entry && (entry->key == KVSTORE_NO_KEY || sequence > entry->sequence)) {
+                entry->key = key;
+                entry->address = (firstPage + page) * AT24C256_PAGE_SIZE + offset;
+                entry->sequence = sequence;
+            }
+
+            // The head follows the newest record of all
+            if (!found || sequence >= store->sequence) {
+                found = 1;
+                store->sequence = sequence + 1;
+                store->headPage = page;
+                store->headOffset = offset + size;
+            }
+            offset += size;
+        }
+    }
+
+    KVSTORE_UpdateFreePages(store);
+    return KVSTORE_OK;
+}
+
+/*
+ * @brief Reads the value of a key.
+ *
+ * @param store The store.
+ * @param key The key.
+ * @param value Buffer receiving the value.
+ * @param size Size of the buffer.
+ * @param length Receives the length of the value, or NULL.
+ * @return KVSTORE_OK, KVSTORE_NOT_FOUND, KVSTORE_ERROR_SIZE, KVSTORE_ERROR_CORRUPT or an I2C error.
+ */
+uint8_t KVSTORE_Get(KVSTORE_Store *store, uint16_t key, uint8_t *value, uint8_t size, uint8_t *length) {
+    KVSTORE_Entry *entry = KVSTORE_Find(store, key, 0);
+    if (!entry) return KVSTORE_NOT_FOUND;
+
+    // The record never crosses a page, so one read of the rest of the page covers it
+    uint8_t data[AT24C256_PAGE_SIZE];
+    uint8_t offset = entry->address & (AT24C256_PAGE_SIZE - 1);
+    uint8_t status = AT24C256_Read(store->eepromAddress, entry->address, data + offset, AT24C256_PAGE_SIZE - offset);
+    if (status != I2C_OK) return status;
+    if (!KVSTORE_ParseRecord(data, offset)) return KVSTORE_ERROR_CORRUPT;
+
+    uint8_t valueLength = data[offset + KVSTORE_LENGTH];
+    if (length) *length = valueLength;
+    if (valueLength > size) return KVSTORE_ERROR_SIZE;
+    memcpy(value, &data[offset + KVSTORE_VALUE], valueLength);
+    return KVSTORE_OK;
+}
+
+/*
+ * @brief Writes the value of a key by appending a record.
+ *
+ * @param store The store.
+ * @param key The key, any value but KVSTORE_NO_KEY.
+ * @param value The value.
+ * @param length Length of the value, up to KVSTORE_MAX_VALUE.
+ * @return KVSTORE_OK, KVSTORE_ERROR_SIZE, KVSTORE_ERROR_FULL or an I2C error.
+ */
+uint8_t KVSTORE_Put(KVSTORE_Store *store, uint16_t key, const uint8_t *value, uint8_t length) {
+    if (length > KVSTORE_MAX_VALUE || key == KVSTORE_NO_KEY) return KVSTORE_ERROR_SIZE;
+    if (!KVSTORE_Find(store, key, 1)) return KVSTORE_ERROR_FULL;
+
+    // Free pages before the reserve kept for compaction runs out
+    uint8_t needsPage = store->headOffset + length + KVSTORE_RECORD_OVERHEAD > AT24C256_PAGE_SIZE;
+    while (needsPage && store->freePages <= KVSTORE_RESERVE_PAGES) {
+        uint16_t freePages = store->freePages;
+        uint8_t status = KVSTORE_CompactPage(store);
+        if (status != KVSTORE_OK) return status;
+        if (store->freePages <= freePages) break;  // Live records fill the log
+        needsPage = store->headOffset + length + KVSTORE_RECORD_OVERHEAD > AT24C256_PAGE_SIZE;
+    }
+
+    return KVSTORE_Append(store, key, value, length);
+}
+
+/*
+ * @brief Compacts the oldest page when free pages run low; call from the main loop.
+ *
+ * @param store The store.
+ * @return KVSTORE_OK, or an error of the compaction.
+ *
+ * Each call moves the live records of at most one page, so it keeps the time
+ * spent per call short.
+ */
+uint8_t KVSTORE_Compact(KVSTORE_Store *store) {
+    if (store->freePages >= KVSTORE_COMPACT_PAGES) return KVSTORE_OK;
+    return KVSTORE_CompactPage(store);
+}
@@ -0,0 +1,150 @@
+/*
+ * Header guard to prevent multiple inclusions of the "kvstore.h" header file.
+ */
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+#include <stdint.h>
+
+#include "../at24c256/at24c256.h"
+
+/*
+ * Declarations of functions for the log-structured key-value store.
+ *
+ * Values are never updated in place. Every write appends a record to the head
+ * of a log that wraps around a range of AT24C256 pages, so wear spreads over
+ * the whole range instead of concentrating on a few fixed addresses. A record
+ * never crosses a page and is laid out as:
+ *
+ *     sequence (4 bytes) | key (2 bytes) | length (1 byte) | value | CRC-CCITT (2 bytes)
+ *
+ * with multi-byte fields little-endian. Sequence numbers grow by one per
+ * record and never wrap in the life of the device; within a page they must
+ * increase, which rejects stale records left behind a page's newest ones.
+ * Mounting scans the range once and
+ * rebuilds an index in SRAM mapping each key to its newest record, so a lookup
+ * is one read and an update one append. A record torn by a power failure fails
+ * its CRC and is ignored, leaving the previous value in force.
+ *
+ * Before the head reuses a page, compaction copies the live records of the
+ * oldest page to the head. KVSTORE_Compact does this ahead of time from the
+ * main loop; writes only compact when the log is about to run out of pages.
+ */
+
+/*
+ * @brief Number of keys the index can hold; a power of two. Each costs 8 bytes of SRAM.
+ */
+#ifndef KVSTORE_INDEX_SIZE
+#define KVSTORE_INDEX_SIZE 32
+#endif
+
+/*
+ * @brief Bytes a record adds to its value: sequence, key, length and CRC.
+ */
+#define KVSTORE_RECORD_OVERHEAD 9
+
+/*
+ * @brief Largest value, in bytes.
+ */
+#define KVSTORE_MAX_VALUE (AT24C256_PAGE_SIZE - KVSTORE_RECORD_OVERHEAD)
+
+/*
+ * @brief Free pages below which KVSTORE_Compact starts compacting.
+ */
+#ifndef KVSTORE_COMPACT_PAGES
+#define KVSTORE_COMPACT_PAGES 16
+#endif
+
+/*
+ * @brief Free pages kept for compaction; writes compact first when fewer are left.
+ */
+#define KVSTORE_RESERVE_PAGES 2
+
+/*
+ * @brief Key marking an empty index entry; it cannot be stored.
+ */
+#define KVSTORE_NO_KEY 0xFFFF
+
+/*
+ * Status codes besides I2C_OK and the I2C_ERROR_* codes.
+ */
+#define KVSTORE_OK 0                // Same value as I2C_OK
+#define KVSTORE_NOT_FOUND 0x10      // No record for the key
+#define KVSTORE_ERROR_SIZE 0x11     // Value longer than KVSTORE_MAX_VALUE or than the caller's buffer
+#define KVSTORE_ERROR_FULL 0x12     // Index full, or live records fill the log
+#define KVSTORE_ERROR_CORRUPT 0x13  // The record read back failed its CRC
+
+/*
+ * @brief An index entry: where the newest record of a key is.
+ */
+typedef struct {
+    uint16_t key;       // Key, or KVSTORE_NO_KEY
+    uint16_t address;   // EEPROM address of the record
+    uint32_t sequence;  // Sequence number of the record
+} KVSTORE_Entry;
+
+/*
+ * @brief State of a key-value store.
+ */
+typedef struct {
+    uint16_t eepromAddress;                   // I2C address of the EEPROM device
+    uint16_t firstPage;                       // First page of the log
+    uint16_t pageCount;                       // Number of pages in the log
+    uint16_t headPage;                        // Page records are appended to, relative to firstPage
+    uint8_t headOffset;                       // Offset of the next record in the head page
+    uint16_t freePages;                       // Pages after the head page holding no live record
+    uint32_t sequence;                        // Sequence number of the next record
+    KVSTORE_Entry index[KVSTORE_INDEX_SIZE];  // Open-addressing hash table of keys
+} KVSTORE_Store;
+
+/*
+ * @brief Mounts a store, rebuilding its index from the records in EEPROM.
+ *
+ * @param store The store to mount.
+ * @param eepromAddress The I2C address of the EEPROM device.
+ * @param firstPage The first page of the log.
+ * @param pageCount The number of pages of the log, at least KVSTORE_RESERVE_PAGES + 2.
+ * @return KVSTORE_OK, KVSTORE_ERROR_FULL if the log holds more keys than KVSTORE_INDEX_SIZE, or the I2C error
+ *         of a page read.
+ *
+ * Reads every page of the log once. A blank or foreign range mounts as an
+ * empty store. A store that fails to mount must not be written, since the
+ * pages of the keys left out of the index would count as free.
+ */
+uint8_t KVSTORE_Mount(KVSTORE_Store *store, uint16_t eepromAddress, uint16_t firstPage, uint16_t pageCount);
+
+/*
+ * @brief Reads the value of a key.
+ *
+ * @param store The store.
+ * @param key The key.
+ * @param value Buffer receiving the value.
+ * @param size Size of the buffer.
+ * @param length Receives the length of the value, or NULL.
+ * @return KVSTORE_OK, KVSTORE_NOT_FOUND, KVSTORE_ERROR_SIZE, KVSTORE_ERROR_CORRUPT or an I2C error.
+ */
+uint8_t KVSTORE_Get(KVSTORE_Store *store, uint16_t key, uint8_t *value, uint8_t size, uint8_t *length);
+
+/*
+ * @brief Writes the value of a key by appending a record.
+ *
+ * @param store The store.
+ * @param key The key, any value but KVSTORE_NO_KEY.
+ * @param value The value.
+ * @param length Length of the value, up to KVSTORE_MAX_VALUE.
+ * @return KVSTORE_OK, KVSTORE_ERROR_SIZE, KVSTORE_ERROR_FULL or an I2C error.
+ */
+uint8_t KVSTORE_Put(KVSTORE_Store *store, uint16_t key, const uint8_t *value, uint8_t length);
+
+/*
+ * @brief Compacts the oldest page when free pages run low; call from the main loop.
+ *
+ * @param store The store.
+ * @return KVSTORE_OK, or an error of the compaction.
+ *
+ * Each call moves the live records of at most one page, so it keeps the time
+ * spent per call short.
+ */
+uint8_t KVSTORE_Compact(KVSTORE_Store *store);
+
+#endif  // KVSTORE_H
@@ -0,0 +1,97 @@
+/*
+ * Include the header file for number formatting.
+ */
+#include "numfmt.h"
+
+#include <avr/pgmspace.h>
+
+/*
+ * @brief Powers of ten used to extract digits, from the most significant to the tens.
+ */
+static const uint32_t NUMFMT_POWERS[] PROGMEM = {1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+                                                 10000UL,      1000UL,      100UL,      10UL};
+
+#define NUMFMT_POWER_COUNT (sizeof(NUMFMT_POWERS) / sizeof(NUMFMT_POWERS[0]))
+
+/*
+ * @brief Formats an unsigned integer with a minimum number of digits.
+ *
+ * @param value The value to format.
+ * @param minDigits The minimum number of digits; shorter values are padded with leading zeros.
+ * @param buffer The buffer receiving the null-terminated text (at least NUMFMT_BUFFER_SIZE bytes).
+ * @return The number of characters written, excluding the null terminator.
+ */
+uint8_t NUMFMT_FormatUnsigned(uint32_t value, uint8_t minDigits, char *buffer) {
+    uint8_t length = 0;
+
+    for (uint8_t i = 0; i < NUMFMT_POWER_COUNT; i++) {
+        uint32_t power = pgm_read_dword(&NUMFMT_POWERS[i]);
+        char digit = '0';
+
+        // Count how many times the power fits instead of dividing
+        while (value >= power) {
+            value -= power;
+            digit++;
+        }
+
+        // Skip leading zeros unless padding is requested for this position
+        if (digit != '0' || length > 0 || (NUMFMT_POWER_COUNT + 1 - i) <= minDigits) {
+            buffer[length++] = digit;
+        }
+    }
+
+    // The remainder is the units digit
+    buffer[length++] = '0' + (uint8_t)value;
+    buffer[length] = '\0';
+    return length;
+}
+
+/*
+ * @brief Formats a signed integer.
+ *
+ * @param value The value to format.
+ * @param buffer The buffer receiving the null-terminated text (at least NUMFMT_BUFFER_SIZE bytes).
+ * @return The number of characters written, excluding the null terminator.
+ */
+uint8_t NUMFMT_FormatInt(int32_t value, char *buffer) {
+    if (value < 0) {
+        buffer[0] = '-';
+        // Negate in unsigned arithmetic so INT32_MIN is handled as well
+        return NUMFMT_FormatUnsigned(0UL - (uint32_t)value, 1, buffer + 1) + 1;
+    }
+    return NUMFMT_FormatUnsigned((uint32_t)value, 1, buffer);
+}
+
+/*
+ * @brief Formats a fixed-point value.
+ *
+ * @param value The value scaled by 10^decimals (for example 1234 with 2 decimals is "12.34").
+ * @param decimals The number of digits after the decimal point (0 to 9).
+ * @param buffer The buffer receiving the null-terminated text (at least NUMFMT_BUFFER_SIZE bytes).
+ * @return The number of characters written, excluding the null terminator.
+ */
+uint8_t NUMFMT_FormatFixed(int32_t value, uint8_t decimals, char *buffer) {
+    if (decimals == 0) {
+        return NUMFMT_FormatInt(value, buffer);
+    }
+    if (decimals > NUMFMT_POWER_COUNT) {
+        decimals = NUMFMT_POWER_COUNT;
+    }
+
+    uint8_t length = 0;
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0) {
+        buffer[length++] = '-';
+        magnitude = 0UL - magnitude;
+    }
+
+    // Keep at least one digit in front of the decimal point
+    length += NUMFMT_FormatUnsigned(magnitude, decimals + 1, buffer + length);
+
+    // Shift the fractional digits (and the terminator) right to make room for the point
+    for (uint8_t i = 0; i <= decimals; i++) {
+        buffer[length + 1 - i] = buffer[length - i];
+    }
+    buffer[length - decimals] = '.';
+    return length + 1;
+}
@@ -0,0 +1,47 @@
+#ifndef NUMFMT_H
+#define NUMFMT_H
+
+#include <stdint.h>
+
+/*
+ * Declarations of functions for number to text formatting.
+ *
+ * These functions replace sprintf for the common cases of integers and fixed-point values. Digits are produced by
+ * subtracting powers of ten, so no 32-bit division is pulled in on the AVR.
+ */
+
+/*
+ * @brief Maximum length of a formatted number, including sign, decimal point and the null terminator.
+ */
+#define NUMFMT_BUFFER_SIZE 13
+
+/*
+ * @brief Formats an unsigned integer with a minimum number of digits.
+ *
+ * @param value The value to format.
+ * @param minDigits The minimum number of digits; shorter values are padded with leading zeros.
+ * @param buffer The buffer receiving the null-terminated text (at least NUMFMT_BUFFER_SIZE bytes).
+ * @return The number of characters written, excluding the null terminator.
+ */
+uint8_t NUMFMT_FormatUnsigned(uint32_t value, uint8_t minDigits, char *buffer);
+
+/*
+ * @brief Formats a signed integer.
+ *
+ * @param value The value to format.
+ * @param buffer The buffer receiving the null-terminated text (at least NUMFMT_BUFFER_SIZE bytes).
+ * @return The number of characters written, excluding the null terminator.
+ */
+uint8_t NUMFMT_FormatInt(int32_t value, char *buffer);
+
+/*
+ * @brief Formats a fixed-point value.
+ *
+ * @param value The value scaled by 10^decimals (for example 1234 with 2 decimals is "12.34").
+ * @param decimals The number of digits after the decimal point (0 to 9).
+ * @param buffer The buffer receiving the null-terminated text (at least NUMFMT_BUFFER_SIZE bytes).
+ * @return The number of characters written, excluding the null terminator.
+ */
+uint8_t NUMFMT_FormatFixed(int32_t value, uint8_t decimals, char *buffer);
+
+#endif  // NUMFMT_H
@@ -8,6 +8,31 @@
  */
 #include "../../protocols/i2c/i2c.h"
 
+/*
+ * @brief Runs one transaction with the PCF8574 device.
+ *
+ * @param address The I2C address of the PCF8574 device.
+ * @param writeData Bytes to write, or NULL.
+ * @param writeLength Number of bytes in writeData.
+ * @param readData Buffer for the bytes read, or NULL.
+ * @param readLength Number of bytes to read into readData.
+ * @return I2C_OK, or the I2C error that ended the transfer.
+ */
+static uint8_t PCF8574_Transfer(uint8_t address, const uint8_t *writeData, uint8_t writeLength, uint8_t *readData,
+                                uint8_t readLength) {
+    I2C_Transaction transaction;
+    transaction.address = address;
+    transaction.frequency = PCF8574_FREQUENCY;
+    transaction.prefixLength = 0;
+    transaction.writeData = writeData;
+    transaction.writeLength = writeLength;
+    transaction.readData = readData;
+    transaction.readLength = readLength;
+    transaction.chunkCallback = NULL;
+    transaction.callback = NULL;
+    return I2C_Transfer(&transaction);
+}
+
 /*
  * @brief Reads a byte from the PCF8574 device at the specified address.
  *
@@ -15,11 +40,8 @@
  * @return The byte read from the PCF8574 device.
  */
 uint8_t PCF8574_ReadByte(uint8_t address) {
-    uint8_t data;
-    I2C_Start();                    // Send START condition
-    I2C_Write((address << 1) | 1);  // Send address with read bit (1)
-    data = I2C_ReadNack();          // Read a byte of data from PCF8574
-    I2C_Stop();                     // Send STOP condition
+    uint8_t data = 0xFF;
+    PCF8574_Transfer(address, NULL, 0, &data, 1);  // Read a byte of data from PCF8574
     return data;
 }
 
@@ -28,12 +50,10 @@ uint8_t PCF8574_ReadByte(uint8_t address) {
  *
  * @param address The I2C address of the PCF8574 device.
  * @param data The byte to be written to the PCF8574 device.
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void PCF8574_WriteByte(uint8_t address, uint8_t data) {
-    I2C_Start();              // Send START condition
-    I2C_Write(address << 1);  // Send address with write bit (0)
-    I2C_Write(data);          // Send the data
-    I2C_Stop();               // Send STOP condition
+uint8_t PCF8574_WriteByte(uint8_t address, uint8_t data) {
+    return PCF8574_Transfer(address, &data, 1, NULL, 0);  // Send the data
 }
 
 /*
@@ -54,13 +74,18 @@ int PCF8574_ReadPin(uint8_t address, uint8_t pin) {
  * @param address The I2C address of the PCF8574 device.
  * @param pin The pin number to which the state is to be written.
  * @param state The state to be written to the specified pin (0 or 1).
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void PCF8574_WritePin(uint8_t address, uint8_t pin, uint8_t state) {
-    uint8_t data = PCF8574_ReadByte(address);
+uint8_t PCF8574_WritePin(uint8_t address, uint8_t pin, uint8_t state) {
+    // Read-modify-write; on a failed read, writing would drive the other pins from garbage
+    uint8_t data;
+    uint8_t status = PCF8574_Transfer(address, NULL, 0, &data, 1);
+    if (status != I2C_OK) return status;
+
     if (state) {
         data |= (1 << pin);  // Set the bit (write 1 to the pin)
     } else {
         data &= ~(1 << pin);  // Clear the bit (write 0 to the pin)
     }
-    PCF8574_WriteByte(address, data);
+    return PCF8574_WriteByte(address, data);
 }
@@ -3,6 +3,13 @@
 
 #include <stdint.h>
 
+/*
+ * @brief SCL frequency used for every transfer with the PCF8574, in Hz.
+ *
+ * Standard-mode rate, the fastest the PCF8574 supports.
+ */
+#define PCF8574_FREQUENCY 100000UL
+
 /*
  * Declarations of functions for PCF8574 I/O Expander.
  */
@@ -20,8 +27,9 @@ uint8_t PCF8574_ReadByte(uint8_t address);
  *
  * @param address The I2C address of the PCF8574 device.
  * @param data The byte to be written to the PCF8574 device.
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void PCF8574_WriteByte(uint8_t address, uint8_t data);
+uint8_t PCF8574_WriteByte(uint8_t address, uint8_t data);
 
 /*
  * @brief Reads the state of a specific pin from the PCF8574 device.
@@ -38,7 +46,8 @@ int PCF8574_ReadPin(uint8_t address, uint8_t pin);
  * @param address The I2C address of the PCF8574 device.
  * @param pin The pin number to which the state is to be written.
  * @param state The state to be written to the specified pin (0 or 1).
+ * @return I2C_OK, or the I2C error that ended the transfer.
  */
-void PCF8574_WritePin(uint8_t address, uint8_t pin, uint8_t state);
+uint8_t PCF8574_WritePin(uint8_t address, uint8_t pin, uint8_t state);
 
 #endif  // PCF8574_H
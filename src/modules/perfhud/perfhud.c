@@ -0,0 +1,140 @@
+/*
+ * Include the header file for the performance overlay.
+ */
+#include "perfhud.h"
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#include "../numfmt/numfmt.h"
+
+/*
+ * @brief Labels of the overlay lines, each padded to four characters.
+ */
+static const char PERFHUD_LABELS[PERFHUD_LINES][5] PROGMEM = {"ms  ", "B   ", "win ", "px  ", "idl%"};
+
+/*
+ * @brief Shows a value on one line, redrawing only the characters that changed.
+ *
+ * @param hud The overlay.
+ * @param line The line index.
+ * @param value The value, scaled by 10 ^ decimals.
+ * @param decimals The number of decimal places.
+ */
+static void PERFHUD_ShowValue(PERFHUD_Hud *hud, uint8_t line, int32_t value, uint8_t decimals) {
+    char text[PERFHUD_LINE_LENGTH];
+    char number[NUMFMT_BUFFER_SIZE];
+    uint8_t length = NUMFMT_FormatFixed(value, decimals, number);
+    uint8_t column = 0;
+
+    // Label on the left, value right-aligned, or "#" marks if it does not fit
+    for (; column < 4; column++) {
+        text[column] = pgm_read_byte(&PERFHUD_LABELS[line][column]);
+    }
+    if (length > PERFHUD_LINE_LENGTH - 1 - 4) {
+        while (column < PERFHUD_LINE_LENGTH - 1) {
+            text[column++] = '#';
+        }
+    }
+    while (column < PERFHUD_LINE_LENGTH - 1 - length) {
+        text[column++] = ' ';
+    }
+    for (uint8_t i = 0; column < PERFHUD_LINE_LENGTH - 1; i++) {
+        text[column++] = number[i];
+    }
+
+    char *shown = hud->lines[line];
+    for (column = 0; column < PERFHUD_LINE_LENGTH - 1; column++) {
+        if (text[column] != shown[column]) {
+            ST77XX_DrawChar(hud->x + column * 6, hud->y + line * 8, text[column], hud->textColor,
+                            hud->backgroundColor);
+            shown[column] = text[column];
+        }
+    }
+}
+
+/*
+ * @brief Starts Timer1 and draws the empty overlay.
+ *
+ * @param hud The overlay to initialize.
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param textColor The color of the text.
+ * @param backgroundColor The color behind the text.
+ */
+void PERFHUD_Init(PERFHUD_Hud *hud, int16_t x, int16_t y, uint16_t textColor, uint16_t backgroundColor) {
+    hud->x = x;
+    hud->y = y;
+    hud->textColor = textColor;
+    hud->backgroundColor = backgroundColor;
+
+    // Timer1 free-running from F_CPU / 1024
+    TCCR1A = 0;
+    TCCR1B = (1 << CS12) | (1 << CS10);
+    hud->periodStart = TCNT1;
+    hud->idleTicks = 0;
+
+    ST77XX_FillRect(x, y, (PERFHUD_LINE_LENGTH - 1) * 6, PERFHUD_LINES * 8, backgroundColor);
+    for (uint8_t line = 0; line < PERFHUD_LINES; line++) {
+        for (uint8_t column = 0; column < PERFHUD_LINE_LENGTH - 1; column++) {
+            hud->lines[line][column] = ' ';
+        }
+        hud->lines[line][PERFHUD_LINE_LENGTH - 1] = '\0';
+    }
+    PERFHUD_BeginFrame(hud);
+}
+
+/*
+ * @brief Marks the start of a frame and clears the drawing counters.
+ *
+ * @param hud The overlay.
+ */
+void PERFHUD_BeginFrame(PERFHUD_Hud *hud) {
+    ST77XX_Stats stats;
+
+    ST77XX_TakeStats(&stats);
+    hud->frameStart = TCNT1;
+}
+
+/*
+ * @brief Marks the end of a frame and shows its measurements.
+ *
+ * @param hud The overlay.
+ *
+ * The measurements are taken before the overlay itself is updated, so its
+ * own drawing is not counted in the frame.
+ */
+void PERFHUD_EndFrame(PERFHUD_Hud *hud) {
+    uint16_t now = TCNT1;
+    uint16_t ticks = now - hud->frameStart;
+    uint16_t period = now - hud->periodStart;
+    uint16_t idle = hud->idleTicks;
+    ST77XX_Stats stats;
+
+    ST77XX_TakeStats(&stats);
+    hud->periodStart = now;
+    hud->idleTicks = 0;
+
+    // One tick is 1024 / F_CPU seconds; show tenths of a millisecond
+    uint32_t tenths = ((uint32_t)ticks * 10240UL) / (F_CPU / 1000UL);
+
+    PERFHUD_ShowValue(hud, 0, tenths, 1);
+    PERFHUD_ShowValue(hud, 1, stats.bytes, 0);
+    PERFHUD_ShowValue(hud, 2, stats.windows, 0);
+    PERFHUD_ShowValue(hud, 3, stats.pixels, 0);
+    PERFHUD_ShowValue(hud, 4, period ? (uint32_t)idle * 100 / period : 0, 0);
+}
+
+/*
+ * @brief Marks the start of time the main loop spends waiting.
+ *
+ * @param hud The overlay.
+ */
+void PERFHUD_BeginIdle(PERFHUD_Hud *hud) { hud->idleStart = TCNT1; }
+
+/*
+ * @brief Marks the end of time the main loop spends waiting, adding it to the idle time.
+ *
+ * @param hud The overlay.
+ */
+void PERFHUD_EndIdle(PERFHUD_Hud *hud) { hud->idleTicks += TCNT1 - hud->idleStart; }
@@ -0,0 +1,94 @@
+/*
+ * Header guard to prevent multiple inclusions of the "perfhud.h" header file.
+ */
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include <stdint.h>
+
+#include "../st77xx/st77xx.h"
+
+/*
+ * Declarations of functions for the performance overlay.
+ *
+ * The overlay shows the time of the last frame together with the ST77XX
+ * drawing counters of that frame (SPI bytes, address windows, DrawPixel
+ * calls) and the CPU idle time. The counters need the driver built with
+ * ST77XX_STATS defined; without it they read as zero. Frame time is measured
+ * with Timer1 running from F_CPU / 1024, so frames up to about 4 s at 16 MHz
+ * are timed.
+ *
+ * Idle time is whatever the main loop brackets with PERFHUD_BeginIdle and
+ * PERFHUD_EndIdle, typically its wait for the next frame. It is shown as a
+ * percentage of the time between two PERFHUD_EndFrame calls.
+ *
+ * Values too wide for their line are shown as "#" marks.
+ *
+ * Each label only redraws the characters that changed since the last frame,
+ * so the overlay adds little traffic to the frame it measures.
+ */
+
+/*
+ * @brief Number of lines and characters per line of the overlay.
+ */
+#define PERFHUD_LINES 5
+#define PERFHUD_LINE_LENGTH 12
+
+/*
+ * @brief State of the performance overlay.
+ */
+typedef struct {
+    int16_t x;                                       // x-coordinate of the top-left corner
+    int16_t y;                                       // y-coordinate of the top-left corner
+    uint16_t textColor;                              // Color of the text
+    uint16_t backgroundColor;                        // Color behind the text
+    uint16_t frameStart;                             // Timer1 count at the start of the frame
+    uint16_t periodStart;                            // Timer1 count at the previous PERFHUD_EndFrame
+    uint16_t idleStart;                              // Timer1 count at PERFHUD_BeginIdle
+    uint16_t idleTicks;                              // Timer1 ticks spent idle since periodStart
+    char lines[PERFHUD_LINES][PERFHUD_LINE_LENGTH];  // Text currently shown on each line
+} PERFHUD_Hud;
+
+/*
+ * @brief Starts Timer1 and draws the empty overlay.
+ *
+ * @param hud The overlay to initialize.
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param textColor The color of the text.
+ * @param backgroundColor The color behind the text.
+ */
+void PERFHUD_Init(PERFHUD_Hud *hud, int16_t x, int16_t y, uint16_t textColor, uint16_t backgroundColor);
+
+/*
+ * @brief Marks the start of a frame and clears the drawing counters.
+ *
+ * @param hud The overlay.
+ */
+void PERFHUD_BeginFrame(PERFHUD_Hud *hud);
+
+/*
+ * @brief Marks the end of a frame and shows its measurements.
+ *
+ * @param hud The overlay.
+ *
+ * The measurements are taken before the overlay itself is updated, so its
+ * own drawing is not counted in the frame.
+ */
+void PERFHUD_EndFrame(PERFHUD_Hud *hud);
+
+/*
+ * @brief Marks the start of time the main loop spends waiting.
+ *
+ * @param hud The overlay.
+ */
+void PERFHUD_BeginIdle(PERFHUD_Hud *hud);
+
+/*
+ * @brief Marks the end of time the main loop spends waiting, adding it to the idle time.
+ *
+ * @param hud The overlay.
+ */
+void PERFHUD_EndIdle(PERFHUD_Hud *hud);
+
+#endif  // PERFHUD_H
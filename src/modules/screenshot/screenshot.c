@@ -0,0 +1,84 @@
+/*
+ * Include the header file for the screenshot streamer.
+ */
+#include "screenshot.h"
+
+#include "../../protocols/uart/uart.h"
+#include "../st77xx/st77xx.h"
+
+/*
+ * @brief Sends a 16-bit value, least significant byte first.
+ *
+ * @param value The value to send.
+ */
+static void SCREENSHOT_SendWord(uint16_t value) {
+    UART_Transmit(value & 0xFF);
+    UART_Transmit(value >> 8);
+}
+
+/*
+ * @brief Sends a frame header.
+ *
+ * @param width The width of the frame.
+ * @param height The height of the frame.
+ */
+static void SCREENSHOT_SendHeader(uint16_t width, uint16_t height) {
+    UART_Transmit('S');
+    UART_Transmit('T');
+    UART_Transmit('7');
+    UART_Transmit('7');
+    SCREENSHOT_SendWord(width);
+    SCREENSHOT_SendWord(height);
+}
+
+/*
+ * @brief Streams a window of the display over UART.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param width The width of the window.
+ * @param height The height of the window.
+ * @return 1 if the window was sent, 0 if an empty frame was sent instead.
+ */
+uint8_t SCREENSHOT_Send(int16_t x, int16_t y, int16_t width, int16_t height) {
+    uint16_t pixels[SCREENSHOT_CHUNK];
+    uint16_t sum = 0;
+
+    // Check both corners up front, so a failed read never leaves a frame half sent
+    if (!ST77XX_ReadPixels(x, y, 1, 1, pixels) ||
+        !ST77XX_ReadPixels(x + width - 1, y + height - 1, 1, 1, pixels)) {
+        SCREENSHOT_SendHeader(0, 0);
+        SCREENSHOT_SendWord(0);
+        return 0;
+    }
+
+    SCREENSHOT_SendHeader(width, height);
+    for (int16_t row = y; row < y + height; row++) {
+        for (int16_t column = x; column < x + width; column += SCREENSHOT_CHUNK) {
+            int16_t count = x + width - column;
+            if (count > SCREENSHOT_CHUNK) count = SCREENSHOT_CHUNK;
+
+            ST77XX_ReadPixels(column, row, count, 1, pixels);
+            for (int16_t i = 0; i < count; i++) {
+                uint8_t high = pixels[i] >> 8;
+                uint8_t low = pixels[i] & 0xFF;
+                UART_Transmit(high);
+                UART_Transmit(low);
+                sum += high + low;
+            }
+        }
+    }
+    SCREENSHOT_SendWord(sum);
+    return 1;
+}
+
+/*
+ * @brief Handles a byte received on the UART.
+ *
+ * @param command The received byte.
+ * @return 1 if the byte was a screenshot request and the whole display was sent, 0 otherwise.
+ */
+uint8_t SCREENSHOT_HandleCommand(uint8_t command) {
+    if (command != SCREENSHOT_COMMAND) return 0;
+    return SCREENSHOT_Send(0, 0, ST77XX_GetWidth(), ST77XX_GetHeight());
+}
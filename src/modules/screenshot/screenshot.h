@@ -0,0 +1,50 @@
+/*
+ * Header guard to prevent multiple inclusions of the "screenshot.h" header file.
+ */
+#ifndef SCREENSHOT_H
+#define SCREENSHOT_H
+
+#include <stdint.h>
+
+/*
+ * Declarations of functions for streaming display content over UART.
+ *
+ * A frame is the magic "ST77", the width and height as little-endian 16-bit
+ * values, width * height RGB565 pixels (big-endian, row-major) and a
+ * little-endian 16-bit sum of the pixel bytes. A panel that cannot be read
+ * back answers with an empty 0x0 frame. tools/serial decodes frames to PNG or
+ * PPM files.
+ */
+
+/*
+ * @brief Command byte that requests a screenshot of the whole display.
+ */
+#define SCREENSHOT_COMMAND 'S'
+
+/*
+ * @brief Number of pixels read from the display at a time.
+ */
+#ifndef SCREENSHOT_CHUNK
+#define SCREENSHOT_CHUNK 32
+#endif
+
+/*
+ * @brief Streams a window of the display over UART.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param width The width of the window.
+ * @param height The height of the window.
+ * @return 1 if the window was sent, 0 if an empty frame was sent instead.
+ */
+uint8_t SCREENSHOT_Send(int16_t x, int16_t y, int16_t width, int16_t height);
+
+/*
+ * @brief Handles a byte received on the UART.
+ *
+ * @param command The received byte.
+ * @return 1 if the byte was a screenshot request and the whole display was sent, 0 otherwise.
+ */
+uint8_t SCREENSHOT_HandleCommand(uint8_t command);
+
+#endif  // SCREENSHOT_H
@@ -0,0 +1,287 @@
+/*
+ * Include the header file for the segmented-digit renderer.
+ */
+#include "segment.h"
+
+#include <avr/pgmspace.h>
+
+#include "../numfmt/numfmt.h"
+#include "../st77xx/st77xx.h"
+
+/*
+ * @brief 7-segment masks for the characters 0x20 (space) to 0x5F (underscore).
+ */
+static const uint8_t SEGMENT_FONT_7[] PROGMEM = {
+    0x00, 0x86, 0x22, 0x00, 0x6D, 0x00, 0x00, 0x02, 0x39, 0x0F, 0x00, 0x00, 0x80, 0x40, 0x80, 0x52,  // space to /
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F, 0x00, 0x00, 0x00, 0x48, 0x00, 0x53,  // 0 to ?
+    0x00, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D, 0x76, 0x30, 0x1E, 0x75, 0x38, 0x55, 0x54, 0x3F,  // @ to O
+    0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x1C, 0x2A, 0x76, 0x6E, 0x5B, 0x39, 0x64, 0x0F, 0x23, 0x08,  // P to _
+};
+
+/*
+ * @brief 14-segment masks for the characters 0x20 (space) to 0x5F (underscore).
+ */
+static const uint16_t SEGMENT_FONT_14[] PROGMEM = {
+    0x0000, 0x4006, 0x0220, 0x12CE, 0x12ED, 0x0CE4, 0x2359, 0x0200,  // space to '
+    0x2400, 0x0900, 0x3FC0, 0x12C0, 0x0800, 0x00C0, 0x4000, 0x0C00,  // ( to /
+    0x0C3F, 0x0406, 0x00DB, 0x008F, 0x00E6, 0x00ED, 0x00FD, 0x0007,  // 0 to 7
+    0x00FF, 0x00EF, 0x1200, 0x0A00, 0x2400, 0x00C8, 0x0900, 0x1083,  // 8 to ?
+    0x02BB, 0x00F7, 0x128F, 0x0039, 0x120F, 0x0079, 0x0071, 0x00BD,  // @ to G
+    0x00F6, 0x1209, 0x001E, 0x2470, 0x0038, 0x0536, 0x2136, 0x003F,  // H to O
+    0x00F3, 0x203F, 0x20F3, 0x00ED, 0x1201, 0x003E, 0x0C30, 0x2836,  // P to W
+    0x2D00, 0x1500, 0x0C09, 0x0039, 0x2100, 0x000F, 0x2800, 0x0008,  // X to _
+};
+
+/*
+ * @brief Fills a diagonal segment as a staircase of window fills.
+ *
+ * @param x Left edge of the bounding box.
+ * @param y Top edge of the bounding box.
+ * @param w Width of the bounding box.
+ * @param h Height of the bounding box.
+ * @param t Segment thickness, used as the step height.
+ * @param descending Non-zero if the segment runs from the top-left to the bottom-right corner.
+ * @param color Color of the segment.
+ */
+static void SEGMENT_FillDiagonal(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t t, uint8_t descending,
+                                 uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+
+    uint8_t steps = h / t;
+    if (steps == 0) steps = 1;
+
+    int16_t stepWidth = w / steps;
+    if (stepWidth < t) stepWidth = t;
+    if (stepWidth > w) stepWidth = w;
+    uint16_t travel = w - stepWidth;
+
+    uint16_t rowStart = 0;
+    for (uint8_t s = 0; s < steps; s++) {
+        uint16_t rowEnd = (uint16_t)h * (s + 1) / steps;
+        uint16_t offset = (steps > 1) ? travel * s / (steps - 1) : 0;
+        int16_t column = descending ? x + offset : x + travel - offset;
+        ST77XX_FillRect(column, y + rowStart, stepWidth, rowEnd - rowStart, color);
+        rowStart = rowEnd;
+    }
+}
+
+/*
+ * @brief Draws one segment of a digit.
+ *
+ * @param display The display the digit belongs to.
+ * @param x Left edge of the digit cell.
+ * @param segment The single segment bit to draw.
+ * @param color Color of the segment.
+ */
+static void SEGMENT_DrawSegment(const SEGMENT_Display *display, int16_t x, uint16_t segment, uint16_t color) {
+    uint8_t t = display->thickness;
+    uint8_t w = display->digitWidth;
+    uint8_t hv = (display->digitHeight - 3 * t) / 2;  // Length of a vertical segment
+    int16_t y = display->y;
+    int16_t midY = y + t + hv;
+    int16_t bottomY = midY + t + hv;
+
+    // Inner width and the column of the center verticals (14-segment only)
+    uint8_t iw = w - 2 * t;
+    int16_t cx = x + (w - t) / 2;
+
+    switch (segment) {
+        case SEGMENT_SEG_A:
+            ST77XX_FillRect(x + t, y, iw, t, color);
+            break;
+        case SEGMENT_SEG_B:
+            ST77XX_FillRect(x + w - t, y + t, t, hv, color);
+            break;
+        case SEGMENT_SEG_C:
+            ST77XX_FillRect(x + w - t, midY + t, t, hv, color);
+            break;
+        case SEGMENT_SEG_D:
+            ST77XX_FillRect(x + t, bottomY, iw, t, color);
+            break;
+        case SEGMENT_SEG_E:
+            ST77XX_FillRect(x, midY + t, t, hv, color);
+            break;
+        case SEGMENT_SEG_F:
+            ST77XX_FillRect(x, y + t, t, hv, color);
+            break;
+        case SEGMENT_SEG_G1:
+            if (display->type == SEGMENT_TYPE_7) {
+                ST77XX_FillRect(x + t, midY, iw, t, color);
+            } else {
+                ST77XX_FillRect(x + t, midY, iw / 2, t, color);
+            }
+            break;
+        case SEGMENT_SEG_G2:
+            ST77XX_FillRect(x + t + iw / 2, midY, iw - iw / 2, t, color);
+            break;
+        case SEGMENT_SEG_H:
+            SEGMENT_FillDiagonal(x + t, y + t, cx - (x + t), hv, t, 1, color);
+            break;
+        case SEGMENT_SEG_J:
+            ST77XX_FillRect(cx, y + t, t, hv, color);
+            break;
+        case SEGMENT_SEG_K:
+            SEGMENT_FillDiagonal(cx + t, y + t, (x + w - t) - (cx + t), hv, t, 0, color);
+            break;
+        case SEGMENT_SEG_L:
+            SEGMENT_FillDiagonal(x + t, midY + t, cx - (x + t), hv, t, 0, color);
+            break;
+        case SEGMENT_SEG_M:
+            ST77XX_FillRect(cx, midY + t, t, hv, color);
+            break;
+        case SEGMENT_SEG_N:
+            SEGMENT_FillDiagonal(cx + t, midY + t, (x + w - t) - (cx + t), hv, t, 1, color);
+            break;
+        case SEGMENT_SEG_DP:
+            // The decimal point sits in the gap to the right of the digit
+            if (display->spacing >= t) {
+                ST77XX_FillRect(x + w + (display->spacing - t) / 2, bottomY, t, t, color);
+            }
+            break;
+    }
+}
+
+/*
+ * @brief Returns the mask of all segments used by the display type.
+ *
+ * @param display The display whose digit type is used.
+ * @return The mask of all segments, including the decimal point.
+ */
+static uint16_t SEGMENT_AllSegments(const SEGMENT_Display *display) {
+    return (display->type == SEGMENT_TYPE_7) ? (0x7F | SEGMENT_SEG_DP) : (0x3FFF | SEGMENT_SEG_DP);
+}
+
+/*
+ * @brief Returns the left edge of a digit cell.
+ *
+ * @param display The display the digit belongs to.
+ * @param index The digit index.
+ * @return The x-coordinate of the digit cell.
+ */
+static int16_t SEGMENT_DigitX(const SEGMENT_Display *display, uint8_t index) {
+    return display->x + index * (display->digitWidth + display->spacing);
+}
+
+/*
+ * @brief Clears the display area and draws every segment in the unlit color.
+ *
+ * @param display The display to initialize.
+ */
+void SEGMENT_Init(SEGMENT_Display *display) {
+    if (display->digitCount > SEGMENT_MAX_DIGITS) {
+        display->digitCount = SEGMENT_MAX_DIGITS;
+    }
+
+    // Clear the whole row of digits with one window
+    ST77XX_FillRect(display->x, display->y, display->digitCount * (display->digitWidth + display->spacing),
+                    display->digitHeight, display->backgroundColor);
+
+    uint16_t all = SEGMENT_AllSegments(display);
+    for (uint8_t i = 0; i < display->digitCount; i++) {
+        // Pretend every segment is lit so switching to the empty mask paints them unlit
+        if (display->offColor != display->backgroundColor) {
+            display->masks[i] = all;
+            SEGMENT_SetMask(display, i, 0);
+        } else {
+            display->masks[i] = 0;
+        }
+    }
+}
+
+/*
+ * @brief Sets the segment mask of a digit, repainting only the segments that changed.
+ *
+ * @param display The display to update.
+ * @param index The digit index, starting at the leftmost digit.
+ * @param mask The new segment mask.
+ */
+void SEGMENT_SetMask(SEGMENT_Display *display, uint8_t index, uint16_t mask) {
+    if (index >= display->digitCount) return;
+
+    mask &= SEGMENT_AllSegments(display);
+    uint16_t changed = display->masks[index] ^ mask;
+    if (changed == 0) return;
+
+    int16_t x = SEGMENT_DigitX(display, index);
+    for (uint16_t segment = 1; segment <= SEGMENT_SEG_DP; segment <<= 1) {
+        if (changed & segment) {
+            SEGMENT_DrawSegment(display, x, segment, (mask & segment) ? display->onColor : display->offColor);
+        }
+    }
+    display->masks[index] = mask;
+}
+
+/*
+ * @brief Returns the segment mask of a character for the display type.
+ *
+ * @param display The display whose digit type is used.
+ * @param c The character; lowercase letters are shown as uppercase, unknown characters are blank.
+ * @return The segment mask of the character.
+ */
+uint16_t SEGMENT_CharToMask(const SEGMENT_Display *display, char c) {
+    if (c >= 'a' && c <= 'z') {
+        c -= 'a' - 'A';
+    }
+    if (c < 0x20 || c > 0x5F) {
+        return 0;
+    }
+    if (display->type == SEGMENT_TYPE_7) {
+        // Bit 7 of the 7-segment font marks the decimal point
+        uint8_t mask = pgm_read_byte(&SEGMENT_FONT_7[c - 0x20]);
+        return (mask & 0x7F) | ((mask & 0x80) ? SEGMENT_SEG_DP : 0);
+    }
+    return pgm_read_word(&SEGMENT_FONT_14[c - 0x20]);
+}
+
+/*
+ * @brief Shows a string on the display, right-aligned.
+ *
+ * @param display The display to update.
+ * @param str The string; a '.' lights the decimal point of the previous character.
+ */
+void SEGMENT_Print(SEGMENT_Display *display, const char *str) {
+    uint16_t masks[SEGMENT_MAX_DIGITS];
+    uint8_t count = 0;
+
+    // Convert the characters to masks, folding decimal points into the previous digit
+    for (; *str; str++) {
+        if (*str == '.' && count > 0 && !(masks[(count - 1) % SEGMENT_MAX_DIGITS] & SEGMENT_SEG_DP)) {
+            masks[(count - 1) % SEGMENT_MAX_DIGITS] |= SEGMENT_SEG_DP;
+            continue;
+        }
+        // Keep only the rightmost digits if the text is too long
+        masks[count % SEGMENT_MAX_DIGITS] = SEGMENT_CharToMask(display, *str);
+        count++;
+    }
+
+    // Right-align the digits and blank the unused ones on the left
+    for (uint8_t i = 0; i < display->digitCount; i++) {
+        int16_t glyph = (int16_t)count - display->digitCount + i;
+        SEGMENT_SetMask(display, i, (glyph >= 0) ? masks[glyph % SEGMENT_MAX_DIGITS] : 0);
+    }
+}
+
+/*
+ * @brief Shows a signed integer on the display, right-aligned.
+ *
+ * @param display The display to update.
+ * @param value The value to show.
+ */
+void SEGMENT_PrintInt(SEGMENT_Display *display, int32_t value) {
+    char buffer[NUMFMT_BUFFER_SIZE];
+    NUMFMT_FormatInt(value, buffer);
+    SEGMENT_Print(display, buffer);
+}
+
+/*
+ * @brief Shows a fixed-point value on the display, right-aligned.
+ *
+ * @param display The display to update.
+ * @param value The value scaled by 10^decimals.
+ * @param decimals The number of digits after the decimal point.
+ */
+void SEGMENT_PrintFixed(SEGMENT_Display *display, int32_t value, uint8_t decimals) {
+    char buffer[NUMFMT_BUFFER_SIZE];
+    NUMFMT_FormatFixed(value, decimals, buffer);
+    SEGMENT_Print(display, buffer);
+}
@@ -0,0 +1,122 @@
+#ifndef SEGMENT_H
+#define SEGMENT_H
+
+#include <stdint.h>
+
+/*
+ * Declarations of functions for the segmented-digit numeric renderer.
+ *
+ * Large numerals are built from rectangular segments, each drawn as a single ST77XX window fill. The renderer keeps
+ * the segment mask of every digit so an update only repaints the segments that changed between the old and the new
+ * character.
+ */
+
+/*
+ * @brief Maximum number of digits per display.
+ */
+#ifndef SEGMENT_MAX_DIGITS
+#define SEGMENT_MAX_DIGITS 8
+#endif
+
+/*
+ * @brief Digit types.
+ */
+#define SEGMENT_TYPE_7 0   // Classic 7-segment digit (a-g) plus decimal point
+#define SEGMENT_TYPE_14 1  // 14-segment alphanumeric digit plus decimal point
+
+/*
+ * @brief Segment bits of a 7-segment digit.
+ */
+#define SEGMENT_SEG_A (1 << 0)  // Top
+#define SEGMENT_SEG_B (1 << 1)  // Upper right
+#define SEGMENT_SEG_C (1 << 2)  // Lower right
+#define SEGMENT_SEG_D (1 << 3)  // Bottom
+#define SEGMENT_SEG_E (1 << 4)  // Lower left
+#define SEGMENT_SEG_F (1 << 5)  // Upper left
+#define SEGMENT_SEG_G (1 << 6)  // Middle
+
+/*
+ * @brief Additional segment bits of a 14-segment digit (the middle bar is split into G1 and G2).
+ */
+#define SEGMENT_SEG_G1 (1 << 6)   // Middle left
+#define SEGMENT_SEG_G2 (1 << 7)   // Middle right
+#define SEGMENT_SEG_H (1 << 8)    // Upper left diagonal
+#define SEGMENT_SEG_J (1 << 9)    // Upper vertical
+#define SEGMENT_SEG_K (1 << 10)   // Upper right diagonal
+#define SEGMENT_SEG_L (1 << 11)   // Lower left diagonal
+#define SEGMENT_SEG_M (1 << 12)   // Lower vertical
+#define SEGMENT_SEG_N (1 << 13)   // Lower right diagonal
+#define SEGMENT_SEG_DP (1 << 14)  // Decimal point (both digit types)
+
+/*
+ * @brief State and geometry of a row of segmented digits.
+ *
+ * The caller fills in the geometry and colors, then calls SEGMENT_Init. The segment thickness should be at most a
+ * third of the digit height, and the spacing at least the thickness when the decimal point is used.
+ */
+typedef struct {
+    int16_t x;                           // Left edge of the first digit
+    int16_t y;                           // Top edge of the digits
+    uint8_t digitWidth;                  // Width of one digit cell
+    uint8_t digitHeight;                 // Height of one digit cell
+    uint8_t thickness;                   // Segment thickness
+    uint8_t spacing;                     // Gap between digit cells, the decimal point is drawn in it
+    uint8_t digitCount;                  // Number of digits (up to SEGMENT_MAX_DIGITS)
+    uint8_t type;                        // SEGMENT_TYPE_7 or SEGMENT_TYPE_14
+    uint16_t onColor;                    // Color of lit segments
+    uint16_t offColor;                   // Color of unlit segments
+    uint16_t backgroundColor;            // Color around the segments
+    uint16_t masks[SEGMENT_MAX_DIGITS];  // Currently drawn segment mask of every digit
+} SEGMENT_Display;
+
+/*
+ * @brief Clears the display area and draws every segment in the unlit color.
+ *
+ * @param display The display to initialize.
+ */
+void SEGMENT_Init(SEGMENT_Display *display);
+
+/*
+ * @brief Sets the segment mask of a digit, repainting only the segments that changed.
+ *
+ * @param display The display to update.
+ * @param index The digit index, starting at the leftmost digit.
+ * @param mask The new segment mask.
+ */
+void SEGMENT_SetMask(SEGMENT_Display *display, uint8_t index, uint16_t mask);
+
+/*
+ * @brief Returns the segment mask of a character for the display type.
+ *
+ * @param display The display whose digit type is used.
+ * @param c The character; lowercase letters are shown as uppercase, unknown characters are blank.
+ * @return The segment mask of the character.
+ */
+uint16_t SEGMENT_CharToMask(const SEGMENT_Display *display, char c);
+
+/*
+ * @brief Shows a string on the display, right-aligned.
+ *
+ * @param display The display to update.
+ * @param str The string; a '.' lights the decimal point of the previous character.
+ */
+void SEGMENT_Print(SEGMENT_Display *display, const char *str);
+
+/*
+ * @brief Shows a signed integer on the display, right-aligned.
+ *
+ * @param display The display to update.
+ * @param value The value to show.
+ */
+void SEGMENT_PrintInt(SEGMENT_Display *display, int32_t value);
+
+/*
+ * @brief Shows a fixed-point value on the display, right-aligned.
+ *
+ * @param display The display to update.
+ * @param value The value scaled by 10^decimals.
+ * @param decimals The number of digits after the decimal point.
+ */
+void SEGMENT_PrintFixed(SEGMENT_Display *display, int32_t value, uint8_t decimals);
+
+#endif  // SEGMENT_H
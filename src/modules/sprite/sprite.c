@@ -0,0 +1,294 @@
+/*
+ * Include the header file for the sprite layer.
+ */
+#include "sprite.h"
+
+#include <avr/pgmspace.h>
+#include <stddef.h>
+
+#include "../st77xx/st77xx.h"
+
+/*
+ * @brief Background source and save-under pool shared by all sprites.
+ */
+static SPRITE_BackgroundCallback SPRITE_backgroundCallback = NULL;
+static uint16_t SPRITE_backgroundColor = 0x0000;
+static uint16_t SPRITE_saveUnderPool[SPRITE_SAVE_UNDER_BUDGET / 2];
+static uint16_t SPRITE_saveUnderUsed = 0;  // Pixels handed out from the pool
+
+/*
+ * @brief Row buffer used to compose one line of a window, wide enough for the union of two boxes.
+ */
+static uint16_t SPRITE_line[2 * SPRITE_MAX_WIDTH];
+
+/*
+ * @brief Returns the smaller of two coordinates.
+ */
+static inline int16_t SPRITE_Min(int16_t a, int16_t b) { return a < b ? a : b; }
+
+/*
+ * @brief Returns the larger of two coordinates.
+ */
+static inline int16_t SPRITE_Max(int16_t a, int16_t b) { return a > b ? a : b; }
+
+/*
+ * @brief Renders a background span through the callback, or with the solid color.
+ *
+ * @param x The x-coordinate of the first pixel of the span.
+ * @param y The y-coordinate of the span.
+ * @param width The number of pixels in the span.
+ * @param pixels The buffer receiving the pixels.
+ */
+static void SPRITE_RenderBackground(int16_t x, int16_t y, int16_t width, uint16_t *pixels) {
+    if (width <= 0) return;
+    if (SPRITE_backgroundCallback != NULL) {
+        SPRITE_backgroundCallback(x, y, width, pixels);
+        return;
+    }
+    while (width--) {
+        *pixels++ = SPRITE_backgroundColor;
+    }
+}
+
+/*
+ * @brief Reads one pixel of a sprite image.
+ *
+ * @param image The image to read.
+ * @param column The column of the pixel.
+ * @param row The row of the pixel.
+ * @param color Receives the pixel color.
+ * @return 1 if the pixel is opaque, 0 if it is transparent.
+ */
+static uint8_t SPRITE_GetPixel(const SPRITE_Image *image, uint8_t column, uint8_t row, uint16_t *color) {
+    if (image->format == SPRITE_FORMAT_MONO) {
+        const uint8_t *bits = (const uint8_t *)image->pixels + row * ((image->width + 7) >> 3);
+        *color = image->color;
+        return (pgm_read_byte(&bits[column >> 3]) & (0x80 >> (column & 7))) != 0;
+    }
+    *color = pgm_read_word((const uint16_t *)image->pixels + row * image->width + column);
+    return *color != image->color;
+}
+
+/*
+ * @brief Streams an area of the screen as one window.
+ *
+ * @param sprite The sprite being drawn or restored.
+ * @param ax Left edge of the area.
+ * @param ay Top edge of the area.
+ * @param aw Width of the area.
+ * @param ah Height of the area.
+ * @param sx Left edge of the box whose background is held in the save-under buffer.
+ * @param sy Top edge of the box whose background is held in the save-under buffer.
+ * @param drawSprite Non-zero to draw the sprite at its current position over the background.
+ *
+ * The background comes from the save-under buffer inside its box and is re-rendered everywhere else.
+ */
+static void SPRITE_Compose(const SPRITE_Sprite *sprite, int16_t ax, int16_t ay, int16_t aw, int16_t ah, int16_t sx,
+                           int16_t sy, uint8_t drawSprite) {
+    const SPRITE_Image *image = sprite->image;
+    uint8_t w = image->width;
+    uint8_t h = image->height;
+
+    // Clip the area against the display bounds
+    if (ax < 0) {
+        aw += ax;
+        ax = 0;
+    }
+    if (ay < 0) {
+        ah += ay;
+        ay = 0;
+    }
+    if (ax + aw > (int16_t)ST77XX_GetWidth()) aw = (int16_t)ST77XX_GetWidth() - ax;
+    if (ay + ah > (int16_t)ST77XX_GetHeight()) ah = (int16_t)ST77XX_GetHeight() - ay;
+    if (aw <= 0 || ah <= 0) return;
+
+    int16_t areaEnd = ax + aw;
+    ST77XX_SetAddressWindow(ax, ay, areaEnd - 1, ay + ah - 1);
+
+    for (int16_t y = ay; y < ay + ah; y++) {
+        // Find the part of the row covered by the save-under buffer
+        int16_t saveStart = areaEnd;
+        int16_t saveEnd = areaEnd;
+        if (sprite->saveUnder != NULL && y >= sy && y < sy + h) {
+            saveStart = SPRITE_Max(sx, ax);
+            saveEnd = SPRITE_Min(sx + w, areaEnd);
+            if (saveStart >= saveEnd) saveStart = saveEnd = areaEnd;
+        }
+
+        // Re-render the background on both sides of the saved part
+        SPRITE_RenderBackground(ax, y, saveStart - ax, SPRITE_line);
+        SPRITE_RenderBackground(saveEnd, y, areaEnd - saveEnd, SPRITE_line + (saveEnd - ax));
+
+        // Saved pixels are stored at (y mod h, x mod w), so they never move when the sprite does
+        if (saveStart < saveEnd) {
+            const uint16_t *cells = sprite->saveUnder + (uint16_t)(y % h) * w;
+            uint8_t cell = saveStart % w;
+            for (int16_t x = saveStart; x < saveEnd; x++) {
+                SPRITE_line[x - ax] = cells[cell];
+                if (++cell == w) cell = 0;
+            }
+        }
+
+        // Draw the opaque sprite pixels over the background
+        if (drawSprite && y >= sprite->y && y < sprite->y + h) {
+            int16_t start = SPRITE_Max(sprite->x, ax);
+            int16_t end = SPRITE_Min(sprite->x + w, areaEnd);
+            for (int16_t x = start; x < end; x++) {
+                uint16_t color;
+                if (SPRITE_GetPixel(image, x - sprite->x, y - sprite->y, &color)) {
+                    SPRITE_line[x - ax] = color;
+                }
+            }
+        }
+
+        ST77XX_WritePixels(SPRITE_line, aw);
+    }
+}
+
+/*
+ * @brief Fills the save-under buffer for the sprite's current box.
+ *
+ * @param sprite The sprite whose background is captured.
+ * @param keepOld Non-zero if the buffer already holds the box at (ox, oy); only the new part is rendered.
+ * @param ox Left edge of the previously saved box.
+ * @param oy Top edge of the previously saved box.
+ */
+static void SPRITE_Capture(SPRITE_Sprite *sprite, uint8_t keepOld, int16_t ox, int16_t oy) {
+    if (sprite->saveUnder == NULL) return;
+
+    uint8_t w = sprite->image->width;
+    uint8_t h = sprite->image->height;
+    int16_t start = SPRITE_Max(sprite->x, 0);
+    int16_t end = SPRITE_Min(sprite->x + w, (int16_t)ST77XX_GetWidth());
+    if (start >= end) return;
+
+    int16_t lastRow = SPRITE_Min(sprite->y + h, (int16_t)ST77XX_GetHeight());
+    for (int16_t y = SPRITE_Max(sprite->y, 0); y < lastRow; y++) {
+        // Pixels shared with the old box are already in place
+        int16_t keepStart = end;
+        int16_t keepEnd = end;
+        if (keepOld && y >= oy && y < oy + h) {
+            keepStart = SPRITE_Max(ox, start);
+            keepEnd = SPRITE_Min(ox + w, end);
+            if (keepStart >= keepEnd) keepStart = keepEnd = end;
+        }
+        if (keepStart == start && keepEnd == end) continue;
+
+        SPRITE_RenderBackground(start, y, keepStart - start, SPRITE_line);
+        SPRITE_RenderBackground(keepEnd, y, end - keepEnd, SPRITE_line + (keepEnd - start));
+
+        uint16_t *cells = sprite->saveUnder + (uint16_t)(y % h) * w;
+        uint8_t cell = start % w;
+        for (int16_t x = start; x < end; x++) {
+            if (x < keepStart || x >= keepEnd) {
+                cells[cell] = SPRITE_line[x - start];
+            }
+            if (++cell == w) cell = 0;
+        }
+    }
+}
+
+/*
+ * @brief Sets how the background under sprites is rendered.
+ *
+ * @param callback The function rendering background spans, or NULL for a solid background.
+ * @param color The solid background color used when no callback is set.
+ */
+void SPRITE_SetBackground(SPRITE_BackgroundCallback callback, uint16_t color) {
+    SPRITE_backgroundCallback = callback;
+    SPRITE_backgroundColor = color;
+}
+
+/*
+ * @brief Initializes a hidden sprite and reserves its save-under buffer.
+ *
+ * @param sprite The sprite to initialize.
+ * @param image The image drawn by the sprite.
+ * @return 1 if a save-under buffer was reserved, 0 if the background will be re-rendered instead, or
+ *         SPRITE_ERROR_WIDTH if the image is wider than SPRITE_MAX_WIDTH; such a sprite is never drawn.
+ */
+uint8_t SPRITE_Init(SPRITE_Sprite *sprite, const SPRITE_Image *image) {
+    uint16_t pixels = (uint16_t)image->width * image->height;
+
+    sprite->image = image;
+    sprite->x = 0;
+    sprite->y = 0;
+    sprite->visible = 0;
+    sprite->saveUnder = NULL;
+
+    // The composing row buffer only holds SPRITE_MAX_WIDTH pixels per box
+    if (image->width > SPRITE_MAX_WIDTH) {
+        sprite->image = NULL;
+        return SPRITE_ERROR_WIDTH;
+    }
+
+    // Reserve the save-under buffer only if it fits in the remaining budget
+    if (pixels <= sizeof(SPRITE_saveUnderPool) / sizeof(uint16_t) - SPRITE_saveUnderUsed) {
+        sprite->saveUnder = SPRITE_saveUnderPool + SPRITE_saveUnderUsed;
+        SPRITE_saveUnderUsed += pixels;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * @brief Moves a sprite, showing it if it was hidden.
+ *
+ * @param sprite The sprite to move.
+ * @param x The new left edge of the sprite.
+ * @param y The new top edge of the sprite.
+ */
+void SPRITE_MoveTo(SPRITE_Sprite *sprite, int16_t x, int16_t y) {
+    if (!sprite->image) return;  // Rejected by SPRITE_Init
+
+    uint8_t w = sprite->image->width;
+    uint8_t h = sprite->image->height;
+    int16_t ox = sprite->x;
+    int16_t oy = sprite->y;
+    uint8_t wasVisible = sprite->visible;
+
+    if (wasVisible && x == ox && y == oy) return;
+
+    sprite->x = x;
+    sprite->y = y;
+    sprite->visible = 1;
+
+    if (wasVisible) {
+        int16_t ux = SPRITE_Min(ox, x);
+        int16_t uy = SPRITE_Min(oy, y);
+        int16_t uw = SPRITE_Max(ox, x) + w - ux;
+        int16_t uh = SPRITE_Max(oy, y) + h - uy;
+
+        // Close moves: restore and draw in one window over the union of both boxes
+        if (uw <= 2 * SPRITE_MAX_WIDTH && (uint32_t)uw * uh <= 2 * (uint32_t)w * h) {
+            SPRITE_Compose(sprite, ux, uy, uw, uh, ox, oy, 1);
+            SPRITE_Capture(sprite, 1, ox, oy);
+            return;
+        }
+
+        // Far moves: restore the old box, then draw the new one
+        SPRITE_Compose(sprite, ox, oy, w, h, ox, oy, 0);
+    }
+
+    SPRITE_Capture(sprite, 0, 0, 0);
+    SPRITE_Compose(sprite, x, y, w, h, x, y, 1);
+}
+
+/*
+ * @brief Hides a sprite, restoring the background under it.
+ *
+ * @param sprite The sprite to hide.
+ */
+void SPRITE_Hide(SPRITE_Sprite *sprite) {
+    if (!sprite->visible) return;
+    SPRITE_Compose(sprite, sprite->x, sprite->y, sprite->image->width, sprite->image->height, sprite->x, sprite->y,
+                   0);
+    sprite->visible = 0;
+}
+
+/*
+ * @brief Returns the save-under memory still available.
+ *
+ * @return The number of free bytes in the save-under budget.
+ */
+uint16_t SPRITE_SaveUnderFree(void) { return sizeof(SPRITE_saveUnderPool) - SPRITE_saveUnderUsed * sizeof(uint16_t); }
@@ -0,0 +1,113 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <stdint.h>
+
+/*
+ * Declarations of functions for the sprite layer.
+ *
+ * Sprites are small RGB565 or 1-bpp images with transparency drawn over a background. The background under a sprite
+ * is kept in an SRAM save-under buffer when the budget allows, otherwise it is re-rendered through the background
+ * callback. A move only touches the old and new bounding boxes: one window over their union when they are close, or
+ * two windows when they are far apart. Sprites must not overlap each other.
+ */
+
+/*
+ * @brief Total SRAM reserved for save-under buffers, in bytes.
+ */
+#ifndef SPRITE_SAVE_UNDER_BUDGET
+#define SPRITE_SAVE_UNDER_BUDGET 512
+#endif
+
+/*
+ * @brief Maximum sprite width in pixels; sizes the row buffer used while composing.
+ */
+#ifndef SPRITE_MAX_WIDTH
+#define SPRITE_MAX_WIDTH 32
+#endif
+
+/*
+ * @brief Sprite pixel formats.
+ */
+#define SPRITE_FORMAT_RGB565 0  // One uint16_t per pixel, pixels equal to the key color are transparent
+#define SPRITE_FORMAT_MONO 1    // 1 bpp rows, MSB first, each row padded to a byte; clear bits are transparent
+
+/*
+ * @brief Status returned by SPRITE_Init for an image wider than SPRITE_MAX_WIDTH.
+ */
+#define SPRITE_ERROR_WIDTH 2
+
+/*
+ * @brief Image of a sprite; the struct lives in RAM, its pixel data in program memory.
+ */
+typedef struct {
+    uint8_t width;       // Width in pixels (up to SPRITE_MAX_WIDTH)
+    uint8_t height;      // Height in pixels
+    uint8_t format;      // SPRITE_FORMAT_RGB565 or SPRITE_FORMAT_MONO
+    uint16_t color;      // Transparent key color (RGB565) or foreground color (1 bpp)
+    const void *pixels;  // Pixel data in program memory
+} SPRITE_Image;
+
+/*
+ * @brief State of a sprite on the screen.
+ */
+typedef struct {
+    const SPRITE_Image *image;  // Image drawn by the sprite, NULL if SPRITE_Init rejected it
+    int16_t x;                  // Left edge of the sprite on the screen
+    int16_t y;                  // Top edge of the sprite on the screen
+    uint8_t visible;            // Non-zero if the sprite is drawn
+    uint16_t *saveUnder;        // Background under the sprite, or NULL if it is re-rendered
+} SPRITE_Sprite;
+
+/*
+ * @brief Renders a horizontal span of the background.
+ *
+ * @param x The x-coordinate of the first pixel of the span.
+ * @param y The y-coordinate of the span.
+ * @param width The number of pixels in the span.
+ * @param pixels The buffer receiving the RGB565 background pixels.
+ */
+typedef void (*SPRITE_BackgroundCallback)(int16_t x, int16_t y, uint8_t width, uint16_t *pixels);
+
+/*
+ * @brief Sets how the background under sprites is rendered.
+ *
+ * @param callback The function rendering background spans, or NULL for a solid background.
+ * @param color The solid background color used when no callback is set.
+ */
+void SPRITE_SetBackground(SPRITE_BackgroundCallback callback, uint16_t color);
+
+/*
+ * @brief Initializes a hidden sprite and reserves its save-under buffer.
+ *
+ * @param sprite The sprite to initialize.
+ * @param image The image drawn by the sprite.
+ * @return 1 if a save-under buffer was reserved, 0 if the background will be re-rendered instead, or
+ *         SPRITE_ERROR_WIDTH if the image is wider than SPRITE_MAX_WIDTH; such a sprite is never drawn.
+ */
+uint8_t SPRITE_Init(SPRITE_Sprite *sprite, const SPRITE_Image *image);
+
+/*
+ * @brief Moves a sprite, showing it if it was hidden.
+ *
+ * @param sprite The sprite to move.
+ * @param x The new left edge of the sprite.
+ * @param y The new top edge of the sprite.
+ */
+void SPRITE_MoveTo(SPRITE_Sprite *sprite, int16_t x, int16_t y);
+
+/*
+ * @brief Hides a sprite, restoring the background under it.
+ *
+ * @param sprite The sprite to hide.
+ */
+void SPRITE_Hide(SPRITE_Sprite *sprite);
+
+/*
+ * @brief Returns the save-under memory still available.
+ *
+ * @return The number of free bytes in the save-under budget.
+ */
+uint16_t SPRITE_SaveUnderFree(void);
+
+#endif  // SPRITE_H
@@ -3,8 +3,99 @@
  */
 #include "st77xx.h"
 
+#include <util/atomic.h>
+
 #include "../spi/spi.h"
 
+/*
+ * @brief Panel wired to the ST77XX_DD_* pins, selected whenever no other device holds the bus.
+ */
+static ST77XX_Device ST77XX_defaultDevice = {
+    &ST77XX_PORT,
+    &ST77XX_DDR,
+    ST77XX_DD_CS,
+    ST77XX_DD_DC,
+    ST77XX_DD_RES,
+    ST77XX_DD_BLK,
+    ST77XX_DISPLAY_WIDTH,
+    ST77XX_DISPLAY_HEIGHT,
+    ST77XX_DISPLAY_X_OFFSET,
+    ST77XX_DISPLAY_Y_OFFSET,
+    ST77XX_Panel::colorOrder,
+    ST77XX_ORDER_ROW_MAJOR,
+    0,
+    0,
+    0,
+    0,
+    0,
+    ST77XX_READBACK_UNKNOWN,
+};
+
+/*
+ * @brief Selected device, whose geometry is used by the drawing functions.
+ */
+static ST77XX_Device *ST77XX_device = &ST77XX_defaultDevice;
+
+/*
+ * @brief Control lines of the selection: one device, or several for a broadcast.
+ */
+static volatile uint8_t *ST77XX_port = &ST77XX_PORT;
+static uint8_t ST77XX_csMask = (1 << ST77XX_DD_CS);
+static uint8_t ST77XX_dcMask = (1 << ST77XX_DD_DC);
+
+/*
+ * @brief Set while a device holds the bus.
+ */
+static volatile uint8_t ST77XX_busTaken = 0;
+
+/*
+ * @brief Members of the current broadcast, or NULL outside one.
+ */
+static ST77XX_Device *const *ST77XX_broadcastDevices = NULL;
+static uint8_t ST77XX_broadcastCount = 0;
+
+#ifdef ST77XX_STATS
+/*
+ * @brief Drawing counters since the last ST77XX_TakeStats.
+ */
+static ST77XX_Stats ST77XX_stats;
+
+#define ST77XX_COUNT(counter) (ST77XX_stats.counter++)
+#else
+#define ST77XX_COUNT(counter)
+#endif
+
+/*
+ * @brief Transmits a byte to the selected panel, counting it when statistics are enabled.
+ *
+ * @param data The byte to transmit.
+ */
+static inline void ST77XX_Transmit(uint8_t data) {
+    ST77XX_COUNT(bytes);
+    SPI_MasterTransmit(data);
+}
+
+/*
+ * @brief Exchanges a byte with the selected panel, counting it when statistics are enabled.
+ *
+ * @param data The byte to transmit.
+ * @return The byte received.
+ */
+static inline uint8_t ST77XX_Transfer(uint8_t data) {
+    ST77XX_COUNT(bytes);
+    return SPI_MasterTransfer(data);
+}
+
+/*
+ * @brief MADCTL values for each clockwise quarter turn from the native orientation.
+ */
+static const uint8_t ST77XX_ROTATIONS[] PROGMEM = {
+    0x00,
+    ST77XX_MADCTL_MX | ST77XX_MADCTL_MV,
+    ST77XX_MADCTL_MX | ST77XX_MADCTL_MY,
+    ST77XX_MADCTL_MY | ST77XX_MADCTL_MV,
+};
+
 /*
  * @brief Sends a data byte to the ST77XX display via SPI.
  *
@@ -14,15 +105,15 @@
  */
 void ST77XX_SendData(uint8_t data) {
     // Activate the Chip Select (CS) of the display
-    ST77XX_PORT &= ~(1 << ST77XX_DD_CS);
+    *ST77XX_port &= ~ST77XX_csMask;
 
     // Set the Data/Command (DC) pin to 1 to send data
-    ST77XX_PORT |= (1 << ST77XX_DD_DC);
+    *ST77XX_port |= ST77XX_dcMask;
 
-    SPI_MasterTransmit(data);
+    ST77XX_Transmit(data);
 
     // Deactivate the Chip Select (CS) of the display
-    ST77XX_PORT |= (1 << ST77XX_DD_CS);
+    *ST77XX_port |= ST77XX_csMask;
 }
 
 /*
@@ -35,38 +126,168 @@ void ST77XX_SendData(uint8_t data) {
  */
 void ST77XX_SendCommand(uint8_t command) {
     // Activate the Chip Select (CS) of the display
-    ST77XX_PORT &= ~(1 << ST77XX_DD_CS);
+    *ST77XX_port &= ~ST77XX_csMask;
 
     // Set the Data/Command (DC) pin to 0 to send a command
-    ST77XX_PORT &= ~(1 << ST77XX_DD_DC);
+    *ST77XX_port &= ~ST77XX_dcMask;
 
-    SPI_MasterTransmit(command);
+    ST77XX_Transmit(command);
 
     // Deactivate the Chip Select (CS) of the display
-    ST77XX_PORT |= (1 << ST77XX_DD_CS);
+    *ST77XX_port |= ST77XX_csMask;
 }
 
+/*
+ * @brief Reset pin level and the delay in milliseconds that follows it, for each reset step.
+ */
+static const uint8_t ST77XX_RESET_STEPS[][2] PROGMEM = {
+    {1, 5}, {0, 5}, {1, 120}, {0, 10}, {1, 120},
+};
+
 /*
  * @brief Resets the ST77XX display.
  *
  * This function resets the ST77XX display.
  */
 void ST77XX_Reset() {
-    // Reset the display
-    ST77XX_PORT |= (1 << ST77XX_DD_RES);
-    _delay_ms(5);
+    // Toggle the reset pin through the same steps as the non-blocking sequence
+    for (uint8_t i = 0; i < sizeof(ST77XX_RESET_STEPS) / sizeof(ST77XX_RESET_STEPS[0]); i++) {
+        if (pgm_read_byte(&ST77XX_RESET_STEPS[i][0])) {
+            *ST77XX_device->port |= (1 << ST77XX_device->res);
+        } else {
+            *ST77XX_device->port &= ~(1 << ST77XX_device->res);
+        }
+        ST77XX_DelayMs(pgm_read_byte(&ST77XX_RESET_STEPS[i][1]));
+    }
+}
 
-    ST77XX_PORT &= ~(1 << ST77XX_DD_RES);
-    _delay_ms(5);
+/*
+ * @brief Describes a panel on the shared SPI bus.
+ *
+ * @param device The device to initialize.
+ * @param port The port of the control pins (e.g. &PORTD).
+ * @param ddr The data direction register of the control pins (e.g. &DDRD).
+ * @param cs The chip select pin.
+ * @param dc The data/command pin.
+ * @param res The reset pin.
+ * @param blk The backlight pin.
+ *
+ * This function drives the chip select high at once, so the panel ignores
+ * traffic meant for other panels until it is acquired and initialized.
+ */
+void ST77XX_InitDevice(ST77XX_Device *device, volatile uint8_t *port, volatile uint8_t *ddr, uint8_t cs, uint8_t dc,
+                       uint8_t res, uint8_t blk) {
+    device->port = port;
+    device->ddr = ddr;
+    device->cs = cs;
+    device->dc = dc;
+    device->res = res;
+    device->blk = blk;
+
+    // Geometry starts in the native orientation
+    device->width = ST77XX_DISPLAY_WIDTH;
+    device->height = ST77XX_DISPLAY_HEIGHT;
+    device->xOffset = ST77XX_DISPLAY_X_OFFSET;
+    device->yOffset = ST77XX_DISPLAY_Y_OFFSET;
+    device->madctl = ST77XX_Panel::colorOrder;
+    device->addressOrder = ST77XX_ORDER_ROW_MAJOR;
+    device->window = 0;
+    device->readBack = ST77XX_READBACK_UNKNOWN;
+
+    // Deselect the panel
+    *port |= (1 << cs);
+    *ddr |= (1 << cs);
+}
+
+/*
+ * @brief Marks the bus as taken.
+ *
+ * @return 1 if the bus was free, 0 if another device holds it.
+ */
+static uint8_t ST77XX_TakeBus(void) {
+    uint8_t taken = 0;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (!ST77XX_busTaken) {
+            ST77XX_busTaken = 1;
+            taken = 1;
+        }
+    }
+    return taken;
+}
 
-    ST77XX_PORT |= (1 << ST77XX_DD_RES);
-    _delay_ms(120);
+/*
+ * @brief Takes the bus and makes a device the target of all drawing functions.
+ *
+ * @param device The device to select.
+ * @return 1 if the bus was taken, 0 if another device holds it.
+ */
+uint8_t ST77XX_Acquire(ST77XX_Device *device) {
+    if (!ST77XX_TakeBus()) return 0;
+
+    ST77XX_device = device;
+    ST77XX_port = device->port;
+    ST77XX_csMask = (1 << device->cs);
+    ST77XX_dcMask = (1 << device->dc);
+    return 1;
+}
+
+/*
+ * @brief Takes the bus and selects several devices at once, so they receive the same commands and pixels.
+ *
+ * @param devices The devices to select; all must use the same port.
+ * @param count The number of devices.
+ * @return 1 if the bus was taken, 0 if another device holds it or the devices are on different ports.
+ *
+ * Clipping and offsets follow the first device, so every member should share
+ * its orientation. Reset and initialization only address the first device.
+ * The devices array must stay valid until ST77XX_Release.
+ */
+uint8_t ST77XX_AcquireBroadcast(ST77XX_Device *const *devices, uint8_t count) {
+    uint8_t csMask = 0;
+    uint8_t dcMask = 0;
+
+    if (count == 0) return 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (devices[i]->port != devices[0]->port) return 0;
+        csMask |= (1 << devices[i]->cs);
+        dcMask |= (1 << devices[i]->dc);
+    }
+    if (!ST77XX_TakeBus()) return 0;
 
-    ST77XX_PORT &= ~(1 << ST77XX_DD_RES);  // Pull reset low
-    _delay_ms(10);
+    // The members may hold different windows and orders, so none of their caches can be trusted
+    for (uint8_t i = 0; i < count; i++) {
+        devices[i]->window = 0;
+        devices[i]->addressOrder = ST77XX_ORDER_UNKNOWN;
+    }
+    ST77XX_broadcastDevices = devices;
+    ST77XX_broadcastCount = count;
+
+    ST77XX_device = devices[0];
+    ST77XX_port = devices[0]->port;
+    ST77XX_csMask = csMask;
+    ST77XX_dcMask = dcMask;
+    return 1;
+}
 
-    ST77XX_PORT |= (1 << ST77XX_DD_RES);  // Pull reset high
-    _delay_ms(120);
+/*
+ * @brief Releases the bus and selects the default panel again.
+ *
+ * After a broadcast, every member takes on the streaming order the first one
+ * was left in, since they all received the same MADCTL commands.
+ */
+void ST77XX_Release(void) {
+    for (uint8_t i = 1; i < ST77XX_broadcastCount; i++) {
+        ST77XX_broadcastDevices[i]->addressOrder = ST77XX_broadcastDevices[0]->addressOrder;
+    }
+    ST77XX_broadcastDevices = NULL;
+    ST77XX_broadcastCount = 0;
+
+    ST77XX_device = &ST77XX_defaultDevice;
+    ST77XX_port = ST77XX_defaultDevice.port;
+    ST77XX_csMask = (1 << ST77XX_defaultDevice.cs);
+    ST77XX_dcMask = (1 << ST77XX_defaultDevice.dc);
+    ST77XX_busTaken = 0;
 }
 
 /*
@@ -80,16 +301,15 @@ typedef struct {
 } ST77XX_Command;
 
 /*
- * @brief Initialization commands stored in program memory.
+ * @brief ST7735S initialization commands stored in program memory.
  */
-const ST77XX_Command initCommands[] PROGMEM = {
+const ST77XX_Command st7735sInitCommands[] PROGMEM = {
     {ST77XX_NOP, 0, {0}, 120},
     {ST77XX_SWRESET, 0, {0}, 120},
     {ST77XX_SLPIN, 0, {0}, 120},
     {ST77XX_PTLON, 0, {0}, 120},
     {ST77XX_NORON, 0, {0}, 120},
-    {ST77XX_INVON, 0, {0}, 120},
-    // {ST77XX_INVOFF, 0, {0}, 120},
+    {ST77XX_Panel::inversion ? ST77XX_INVON : ST77XX_INVOFF, 0, {0}, 120},
     {ST77XX_GAMSET, 1, {0x01}, 10},
     {ST77XX_DISPOFF, 0, {0}, 10},
     {ST77XX_DISPON, 0, {0}, 10},
@@ -100,7 +320,7 @@ const ST77XX_Command initCommands[] PROGMEM = {
     {ST77XX_VSCSAD, 2, {0x00, 0x00}, 10},
     {ST77XX_IDMON, 0, {0}, 10},
     {ST77XX_IDMOFF, 0, {0}, 10},
-    {ST77XX_COLMOD, 1, {0x65}, 10},
+    {ST77XX_COLMOD, 1, {ST77XX_Panel::colorMode}, 10},
     {ST77XX_FRMCTR1, 3, {0x05, 0x3A, 0x3A}, 10},
     {ST77XX_FRMCTR2, 3, {0x05, 0x3A, 0x3A}, 10},
     {ST77XX_FRMCTR3, 6, {0x05, 0x3A, 0x3A, 0x05, 0x3A, 0x3A}, 10},
@@ -124,11 +344,43 @@ const ST77XX_Command initCommands[] PROGMEM = {
      10},
     {ST77XX_GCV, 1, {0xFC}, 10},
     {ST77XX_SLPOUT, 0, {0}, 10},
-    {ST77XX_CASET, 4, {0x00, 0x00, 0x00, ST77XX_DISPLAY_WIDTH}, 120},
-    {ST77XX_RASET, 4, {0x00, 0x00, 0x00, ST77XX_DISPLAY_HEIGHT}, 120},
+    {ST77XX_CASET, 4, {0x00, 0x00, (ST77XX_Panel::width - 1) >> 8, (ST77XX_Panel::width - 1) & 0xFF}, 120},
+    {ST77XX_RASET, 4, {0x00, 0x00, (ST77XX_Panel::height - 1) >> 8, (ST77XX_Panel::height - 1) & 0xFF}, 120},
     {ST77XX_RAMWR, 0, {0}, 120},
 };
 
+/*
+ * @brief ST7789 initialization commands stored in program memory.
+ */
+const ST77XX_Command st7789InitCommands[] PROGMEM = {
+    {ST77XX_SWRESET, 0, {0}, 150},
+    {ST77XX_SLPOUT, 0, {0}, 120},
+    {ST77XX_COLMOD, 1, {ST77XX_Panel::colorMode}, 10},
+    {ST77XX_Panel::inversion ? ST77XX_INVON : ST77XX_INVOFF, 0, {0}, 10},
+    {ST77XX_NORON, 0, {0}, 10},
+    {ST77XX_CASET, 4, {0x00, 0x00, (ST77XX_Panel::width - 1) >> 8, (ST77XX_Panel::width - 1) & 0xFF}, 0},
+    {ST77XX_RASET, 4, {0x00, 0x00, (ST77XX_Panel::height - 1) >> 8, (ST77XX_Panel::height - 1) & 0xFF}, 0},
+    {ST77XX_DISPON, 0, {0}, 10},
+};
+
+/*
+ * @brief Init script of each controller family; only the selected panel's table is linked.
+ */
+template <uint8_t controller>
+struct ST77XX_InitScript;
+
+template <>
+struct ST77XX_InitScript<ST77XX_CONTROLLER_ST7735S> {
+    static const ST77XX_Command *Commands() { return st7735sInitCommands; }
+    enum { count = sizeof(st7735sInitCommands) / sizeof(ST77XX_Command) };
+};
+
+template <>
+struct ST77XX_InitScript<ST77XX_CONTROLLER_ST7789> {
+    static const ST77XX_Command *Commands() { return st7789InitCommands; }
+    enum { count = sizeof(st7789InitCommands) / sizeof(ST77XX_Command) };
+};
+
 /*
  * @brief Delays execution for the given number of milliseconds.
  *
@@ -147,39 +399,369 @@ void ST77XX_DelayMs(uint16_t ms) {
  * resetting the display, and sending initialization commands.
  */
 void ST77XX_InitDisplay() {
-    // Set the control pins as output
-    ST77XX_DDR |= (1 << ST77XX_DD_BLK) | (1 << ST77XX_DD_CS) | (1 << ST77XX_DD_DC) | (1 << ST77XX_DD_RES);
+    // Run the non-blocking sequence, spending its delays here
+    ST77XX_StartInit(NULL);
+    while (!ST77XX_InitTick()) {
+        _delay_ms(1);
+    }
+}
 
-    ST77XX_Reset();  // Reset the display
+/*
+ * @brief Phases of the non-blocking initialization.
+ */
+#define ST77XX_INIT_IDLE 0      // Not started
+#define ST77XX_INIT_RESET 1     // Toggling the reset pin
+#define ST77XX_INIT_COMMANDS 2  // Sending the init script
+#define ST77XX_INIT_SETTLE 3    // Waiting after the last command
+#define ST77XX_INIT_DONE 4      // Panel ready
 
-    // Turn on backlight
-    ST77XX_PORT |= (1 << ST77XX_DD_BLK);
+/*
+ * @brief State of the non-blocking initialization.
+ */
+static struct {
+    ST77XX_Device *device;         // Panel being initialized
+    ST77XX_InitCallback callback;  // Called once the panel is ready
+    volatile uint8_t phase;        // ST77XX_INIT_* phase
+    uint8_t step;                  // Reset step or init script command to run next
+    uint16_t wait;                 // Ticks left before the next step
+} ST77XX_init;
 
-    SPI_MasterInit(2);  // Initialize SPI
+/*
+ * @brief Starts a non-blocking reset and initialization of the selected panel.
+ *
+ * @param callback Function called from ST77XX_InitTick once the panel is ready, or NULL to poll instead.
+ *
+ * The sequence is the one ST77XX_InitDisplay runs, but every delay is counted
+ * in calls to ST77XX_InitTick instead of spent busy-waiting. The panel must stay
+ * selected until the sequence completes; ticks are ignored while another
+ * device is selected.
+ */
+void ST77XX_StartInit(ST77XX_InitCallback callback) {
+    // Set the control pins as output
+    ST77XX_Device *device = ST77XX_device;
+    *device->ddr |= (1 << device->blk) | (1 << device->cs) | (1 << device->dc) | (1 << device->res);
+
+    ST77XX_init.device = device;
+    ST77XX_init.callback = callback;
+    ST77XX_init.step = 0;
+    ST77XX_init.wait = 0;
+    ST77XX_init.phase = ST77XX_INIT_RESET;
+}
 
-    // Iterate through the initCommands array stored in PROGMEM
-    for (uint8_t i = 0; i < sizeof(initCommands) / sizeof(ST77XX_Command); i++) {
-        // Read the command from PROGMEM
-        uint8_t command = pgm_read_byte(&(initCommands[i].command));
-        uint8_t dataCount = pgm_read_byte(&(initCommands[i].dataCount));
-        uint16_t delayMs = pgm_read_word(&(initCommands[i].delayMs));
+/*
+ * @brief Runs the next step of the initialization.
+ *
+ * @return The number of milliseconds to wait before the following step.
+ */
+static uint16_t ST77XX_InitStep(void) {
+    ST77XX_Device *device = ST77XX_init.device;
+    uint8_t step = ST77XX_init.step++;
+
+    if (ST77XX_init.phase == ST77XX_INIT_RESET) {
+        if (step < sizeof(ST77XX_RESET_STEPS) / sizeof(ST77XX_RESET_STEPS[0])) {
+            if (pgm_read_byte(&ST77XX_RESET_STEPS[step][0])) {
+                *device->port |= (1 << device->res);
+            } else {
+                *device->port &= ~(1 << device->res);
+            }
+            return pgm_read_byte(&ST77XX_RESET_STEPS[step][1]);
+        }
 
-        // Send the command
-        ST77XX_SendCommand(command);
+        // Turn on backlight
+        *device->port |= (1 << device->blk);
 
-        // If there are accompanying data bytes, send them as well
-        for (uint8_t j = 0; j < dataCount; j++) {
-            ST77XX_SendData(pgm_read_byte(&(initCommands[i].data[j])));
+        SPI_MasterInit(2);  // Initialize SPI
+        ST77XX_init.phase = ST77XX_INIT_COMMANDS;
+        ST77XX_init.step = 0;
+        return 0;
+    }
+
+    if (ST77XX_init.phase == ST77XX_INIT_COMMANDS) {
+        const ST77XX_Command *initCommands = ST77XX_InitScript<ST77XX_Panel::controller>::Commands();
+        if (step < ST77XX_InitScript<ST77XX_Panel::controller>::count) {
+            // Read the command from PROGMEM and send it with its data bytes
+            uint8_t dataCount = pgm_read_byte(&(initCommands[step].dataCount));
+            ST77XX_SendCommand(pgm_read_byte(&(initCommands[step].command)));
+            for (uint8_t j = 0; j < dataCount; j++) {
+                ST77XX_SendData(pgm_read_byte(&(initCommands[step].data[j])));
+            }
+            return pgm_read_word(&(initCommands[step].delayMs));
         }
 
-        // Wait for the specified delay
-        if (delayMs > 0) {
-            ST77XX_DelayMs(delayMs);
+        // Restore the orientation selected before initialization
+        ST77XX_SendCommand(ST77XX_MADCTL);
+        ST77XX_SendData(device->madctl);
+        device->addressOrder = ST77XX_ORDER_ROW_MAJOR;
+        device->window = 0;  // The init script programmed its own window
+        device->readBack = ST77XX_READBACK_UNKNOWN;
+
+        ST77XX_init.phase = ST77XX_INIT_SETTLE;
+        return 120;
+    }
+
+    ST77XX_init.phase = ST77XX_INIT_DONE;
+    return 0;
+}
+
+/*
+ * @brief Advances the non-blocking initialization; call once per millisecond.
+ *
+ * @return 1 once the panel is ready, 0 while the sequence is still running or not started.
+ *
+ * Call it from the main loop when a timer flags a millisecond, or from the
+ * timer interrupt itself as long as nothing else uses the bus meanwhile.
+ */
+uint8_t ST77XX_InitTick(void) {
+    if (ST77XX_init.phase == ST77XX_INIT_DONE) return 1;
+    if (ST77XX_init.phase == ST77XX_INIT_IDLE || ST77XX_device != ST77XX_init.device) return 0;
+
+    if (ST77XX_init.wait > 0 && --ST77XX_init.wait > 0) return 0;
+
+    // Run steps until one asks for a delay or the sequence completes
+    while (ST77XX_init.wait == 0) {
+        ST77XX_init.wait = ST77XX_InitStep();
+        if (ST77XX_init.phase == ST77XX_INIT_DONE) {
+            if (ST77XX_init.callback) ST77XX_init.callback();
+            return 1;
         }
     }
+    return 0;
+}
+
+/*
+ * @brief Tells whether the last non-blocking initialization has completed.
+ *
+ * @return 1 if the panel is ready, 0 otherwise.
+ */
+uint8_t ST77XX_IsInitDone(void) { return ST77XX_init.phase == ST77XX_INIT_DONE; }
+
+/*
+ * @brief Sets the display orientation by programming MADCTL.
+ *
+ * @param rotation The clockwise rotation in quarter turns (0 to 3) from the panel's native orientation.
+ * @param mirror A combination of ST77XX_MIRROR_X and ST77XX_MIRROR_Y applied to the rotated view.
+ *
+ * This function updates the width, height and offsets used by every drawing
+ * primitive, so coordinates always refer to the rotated view.
+ */
+void ST77XX_SetOrientation(uint8_t rotation, uint8_t mirror) {
+    uint8_t madctl = pgm_read_byte(&ST77XX_ROTATIONS[rotation & 0x03]) | ST77XX_Panel::colorOrder;
+    uint8_t exchanged = madctl & ST77XX_MADCTL_MV;
+
+    // MX and MY act on frame memory axes, which are swapped in the view when MV is set
+    if (mirror & ST77XX_MIRROR_X) madctl ^= exchanged ? ST77XX_MADCTL_MY : ST77XX_MADCTL_MX;
+    if (mirror & ST77XX_MIRROR_Y) madctl ^= exchanged ? ST77XX_MADCTL_MX : ST77XX_MADCTL_MY;
+
+    // A mirrored memory axis moves the visible area to the other end of the frame memory
+    uint16_t columnOffset = (madctl & ST77XX_MADCTL_MX)
+                                ? ST77XX_MEMORY_COLUMNS - ST77XX_DISPLAY_WIDTH - ST77XX_DISPLAY_X_OFFSET
+                                : ST77XX_DISPLAY_X_OFFSET;
+    uint16_t rowOffset = (madctl & ST77XX_MADCTL_MY)
+                             ? ST77XX_MEMORY_ROWS - ST77XX_DISPLAY_HEIGHT - ST77XX_DISPLAY_Y_OFFSET
+                             : ST77XX_DISPLAY_Y_OFFSET;
+
+    ST77XX_Device *device = ST77XX_device;
+    if (exchanged) {
+        device->width = ST77XX_DISPLAY_HEIGHT;
+        device->height = ST77XX_DISPLAY_WIDTH;
+        device->xOffset = rowOffset;
+        device->yOffset = columnOffset;
+    } else {
+        device->width = ST77XX_DISPLAY_WIDTH;
+        device->height = ST77XX_DISPLAY_HEIGHT;
+        device->xOffset = columnOffset;
+        device->yOffset = rowOffset;
+    }
+
+    device->madctl = madctl;
+    device->addressOrder = ST77XX_ORDER_ROW_MAJOR;
+    device->window = 0;  // The cached ranges no longer match the new axes
+    ST77XX_SendCommand(ST77XX_MADCTL);
+    ST77XX_SendData(madctl);
+}
+
+/*
+ * @brief Returns the width of the display in the current orientation.
+ *
+ * @return The width in pixels.
+ */
+uint16_t ST77XX_GetWidth(void) { return ST77XX_device->width; }
+
+/*
+ * @brief Returns the height of the display in the current orientation.
+ *
+ * @return The height in pixels.
+ */
+uint16_t ST77XX_GetHeight(void) { return ST77XX_device->height; }
+
+/*
+ * @brief Sends a CASET or RASET address range, specialized on the panel's coordinate type.
+ */
+template <typename Coordinate>
+struct ST77XX_AddressRange;
+
+/*
+ * @brief Address range for panels whose frame memory fits 8-bit addresses; the high bytes are constant.
+ */
+template <>
+struct ST77XX_AddressRange<uint8_t> {
+    static void Send(uint8_t command, uint8_t start, uint8_t end) {
+        ST77XX_SendCommand(command);
+        ST77XX_SendData(0x00);
+        ST77XX_SendData(start);
+        ST77XX_SendData(0x00);
+        ST77XX_SendData(end);
+    }
+};
+
+/*
+ * @brief Address range for panels with more than 256 columns or rows.
+ */
+template <>
+struct ST77XX_AddressRange<uint16_t> {
+    static void Send(uint8_t command, uint16_t start, uint16_t end) {
+        ST77XX_SendCommand(command);
+        ST77XX_SendData(start >> 8);
+        ST77XX_SendData(start & 0xFF);
+        ST77XX_SendData(end >> 8);
+        ST77XX_SendData(end & 0xFF);
+    }
+};
+
+/*
+ * @brief Programs CASET/RASET (and MADCTL for the streaming order) without starting a memory access.
+ *
+ * @param x0 The first column of the window.
+ * @param y0 The first row of the window.
+ * @param x1 The last column of the window (inclusive).
+ * @param y1 The last row of the window (inclusive).
+ * @param order ST77XX_ORDER_ROW_MAJOR, ST77XX_ORDER_COLUMN_MAJOR or ST77XX_ORDER_ANY.
+ */
+static void ST77XX_ProgramWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t order) {
+    ST77XX_Device *device = ST77XX_device;
+
+    ST77XX_COUNT(windows);
+
+    if (order == ST77XX_ORDER_ANY && device->addressOrder == ST77XX_ORDER_UNKNOWN) order = ST77XX_ORDER_ROW_MAJOR;
+    if (order != ST77XX_ORDER_ANY && order != device->addressOrder) {
+        // Toggling MV keeps the pixel mapping but makes the column counter run along y
+        ST77XX_SendCommand(ST77XX_MADCTL);
+        ST77XX_SendData(order == ST77XX_ORDER_COLUMN_MAJOR ? device->madctl ^ ST77XX_MADCTL_MV : device->madctl);
+        device->addressOrder = order;
+        device->window = 0;
+    }
+
+    ST77XX_Coordinate columnStart = (ST77XX_Coordinate)x0 + device->xOffset;
+    ST77XX_Coordinate columnEnd = (ST77XX_Coordinate)x1 + device->xOffset;
+    ST77XX_Coordinate rowStart = (ST77XX_Coordinate)y0 + device->yOffset;
+    ST77XX_Coordinate rowEnd = (ST77XX_Coordinate)y1 + device->yOffset;
+    if (device->addressOrder == ST77XX_ORDER_COLUMN_MAJOR) {
+        // With rows and columns exchanged, CASET addresses y and RASET addresses x
+        columnStart = (ST77XX_Coordinate)y0 + device->yOffset;
+        columnEnd = (ST77XX_Coordinate)y1 + device->yOffset;
+        rowStart = (ST77XX_Coordinate)x0 + device->xOffset;
+        rowEnd = (ST77XX_Coordinate)x1 + device->xOffset;
+    }
+
+    // Only resend the ranges that differ from what the panel already holds
+    if (!(device->window & ST77XX_WINDOW_COLUMNS) || columnStart != device->columnStart ||
+        columnEnd != device->columnEnd) {
+        ST77XX_AddressRange<ST77XX_Coordinate>::Send(ST77XX_CASET, columnStart, columnEnd);  // X range with offset
+        device->columnStart = columnStart;
+        device->columnEnd = columnEnd;
+    }
+    if (!(device->window & ST77XX_WINDOW_ROWS) || rowStart != device->rowStart || rowEnd != device->rowEnd) {
+        ST77XX_AddressRange<ST77XX_Coordinate>::Send(ST77XX_RASET, rowStart, rowEnd);  // Y range with offset
+        device->rowStart = rowStart;
+        device->rowEnd = rowEnd;
+    }
+    device->window = ST77XX_WINDOW_COLUMNS | ST77XX_WINDOW_ROWS;
+}
+
+/*
+ * @brief Sets the address window, streaming pixels in the requested order.
+ *
+ * @param x0 The first column of the window.
+ * @param y0 The first row of the window.
+ * @param x1 The last column of the window (inclusive).
+ * @param y1 The last row of the window (inclusive).
+ * @param order ST77XX_ORDER_ROW_MAJOR, ST77XX_ORDER_COLUMN_MAJOR or ST77XX_ORDER_ANY.
+ *
+ * Column-major order exchanges rows and columns in MADCTL for as long as it is
+ * needed, which lets column-oriented data such as font glyphs stream as one
+ * window. MADCTL is only resent when the order actually changes.
+ */
+void ST77XX_SetAddressWindowOrdered(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t order) {
+    ST77XX_ProgramWindow(x0, y0, x1, y1, order);
+
+    // Command to write to RAM
+    ST77XX_SendCommand(ST77XX_RAMWR);
+}
+
+/*
+ * @brief Sets the address window for subsequent pixel data.
+ *
+ * @param x0 The first column of the window.
+ * @param y0 The first row of the window.
+ * @param x1 The last column of the window (inclusive).
+ * @param y1 The last row of the window (inclusive).
+ *
+ * This function programs the column and row address ranges and issues the
+ * memory write command, so the display is ready to receive
+ * (x1 - x0 + 1) * (y1 - y0 + 1) pixels in row-major order.
+ */
+void ST77XX_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    ST77XX_SetAddressWindowOrdered(x0, y0, x1, y1, ST77XX_ORDER_ROW_MAJOR);
+}
+
+/*
+ * @brief Streams a single color into the current address window.
+ *
+ * @param color The color to be written.
+ * @param count The number of pixels to write.
+ *
+ * This function keeps the Chip Select (CS) low and the Data/Command (DC) pin
+ * high for the whole run, instead of toggling them for every byte.
+ */
+void ST77XX_WriteColor(uint16_t color, uint32_t count) {
+    uint8_t high = color >> 8;
+    uint8_t low = color & 0xFF;
+
+    // Activate the Chip Select (CS) and select data mode once for the run
+    *ST77XX_port &= ~ST77XX_csMask;
+    *ST77XX_port |= ST77XX_dcMask;
+
+    while (count--) {
+        ST77XX_Transmit(high);
+        ST77XX_Transmit(low);
+    }
 
-    // ST77XX_FillScreenWithColor(0x0000);  // Clear screen with color
-    _delay_ms(120);
+    // Deactivate the Chip Select (CS) of the display
+    *ST77XX_port |= ST77XX_csMask;
+}
+
+/*
+ * @brief Streams a buffer of pixels into the current address window.
+ *
+ * @param pixels The RGB565 pixels to be written.
+ * @param count The number of pixels to write.
+ *
+ * Like ST77XX_WriteColor, this function keeps the Chip Select (CS) low for the
+ * whole buffer.
+ */
+void ST77XX_WritePixels(const uint16_t *pixels, uint16_t count) {
+    // Activate the Chip Select (CS) and select data mode once for the buffer
+    *ST77XX_port &= ~ST77XX_csMask;
+    *ST77XX_port |= ST77XX_dcMask;
+
+    while (count--) {
+        uint16_t color = *pixels++;
+        ST77XX_Transmit(color >> 8);
+        ST77XX_Transmit(color & 0xFF);
+    }
+
+    // Deactivate the Chip Select (CS) of the display
+    *ST77XX_port |= ST77XX_csMask;
 }
 
 /*
@@ -194,24 +776,11 @@ void ST77XX_InitDisplay() {
  */
 void ST77XX_DrawPixel(int16_t x, int16_t y, uint16_t color) {
     // Check if the coordinate is out of bounds of the display
-    if (x < 0 || x >= ST77XX_DISPLAY_WIDTH || y < 0 || y >= ST77XX_DISPLAY_HEIGHT) return;
-
-    // Setting the column (X) address
-    ST77XX_SendCommand(ST77XX_CASET);
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(x + ST77XX_DISPLAY_X_OFFSET);  // XSTART with offset
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(x + ST77XX_DISPLAY_X_OFFSET);  // XEND with offset
-
-    // Setting the row (Y) address
-    ST77XX_SendCommand(ST77XX_RASET);
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(y + ST77XX_DISPLAY_Y_OFFSET);  // YSTART
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(y + ST77XX_DISPLAY_Y_OFFSET);  // YEND
+    if (x < 0 || x >= (int16_t)ST77XX_device->width || y < 0 || y >= (int16_t)ST77XX_device->height) return;
+    ST77XX_COUNT(pixels);
 
-    // Command to write to RAM
-    ST77XX_SendCommand(ST77XX_RAMWR);
+    // Open a 1x1 window at the pixel position, which works in either streaming order
+    ST77XX_SetAddressWindowOrdered(x, y, x, y, ST77XX_ORDER_ANY);
 
     // Sending the high and low bytes of the color
     ST77XX_SendData((uint8_t)(color >> 8));  // High byte of color
@@ -232,7 +801,24 @@ void ST77XX_DrawPixel(int16_t x, int16_t y, uint16_t color) {
  */
 void ST77XX_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t backgroundColor) {
     // Check if the character is out of the display bounds
-    if (x >= ST77XX_DISPLAY_WIDTH || y >= ST77XX_DISPLAY_HEIGHT || (x + 5) < 0 || (y + 7) < 0) return;
+    if (x >= (int16_t)ST77XX_device->width || y >= (int16_t)ST77XX_device->height || (x + 5) < 0 || (y + 7) < 0) return;
+
+    // Opaque characters that fit on screen are streamed as one column-major window, matching the font layout
+    if (backgroundColor != textColor && x >= 0 && y >= 0 && x + 6 <= (int16_t)ST77XX_device->width &&
+        y + 8 <= (int16_t)ST77XX_device->height) {
+        uint16_t pixels[6 * 8];
+        uint8_t index = 0;
+        for (uint8_t column = 0; column < 6; column++) {
+            uint8_t bits = (column == 5) ? 0x0 : pgm_read_byte(&FONT[(c * 5) + column]);
+            for (uint8_t row = 0; row < 8; row++) {
+                pixels[index++] = (bits & 0x1) ? textColor : backgroundColor;
+                bits >>= 1;
+            }
+        }
+        ST77XX_SetAddressWindowOrdered(x, y, x + 5, y + 7, ST77XX_ORDER_COLUMN_MAJOR);
+        ST77XX_WritePixels(pixels, 6 * 8);
+        return;
+    }
 
     uint8_t pixelColumn;  // Column of pixels of the character
     int32_t columnIndex, rowIndex;
@@ -277,10 +863,10 @@ void ST77XX_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t ba
  */
 int16_t ST77XX_DrawString(uint16_t x, uint16_t y, char *str, int16_t textColor, int16_t backgroundColor) {
     while (*str) {
-        if (x + 6 >= ST77XX_DISPLAY_WIDTH) {
+        if (x + 6 >= ST77XX_device->width) {
             x = 0;   // Start of the new line
             y += 8;  // Move to the next line
-            if (y >= ST77XX_DISPLAY_HEIGHT) {
+            if (y >= ST77XX_device->height) {
                 break;  // Exit if visible area is exceeded
             }
         }
@@ -291,6 +877,146 @@ int16_t ST77XX_DrawString(uint16_t x, uint16_t y, char *str, int16_t textColor,
     return (int16_t)((y << 8) | x);
 }
 
+/*
+ * @brief Clips a bitmap to the display.
+ *
+ * @param x The x-coordinate of the bitmap; replaced by the first visible column.
+ * @param y The y-coordinate of the bitmap; replaced by the first visible row.
+ * @param width The width of the bitmap; replaced by the visible width.
+ * @param height The height of the bitmap; replaced by the visible height.
+ * @return 1 if part of the bitmap is visible, 0 otherwise.
+ */
+static uint8_t ST77XX_ClipBitmap(int16_t *x, int16_t *y, int16_t *width, int16_t *height) {
+    if (*x < 0) {
+        *width += *x;
+        *x = 0;
+    }
+    if (*y < 0) {
+        *height += *y;
+        *y = 0;
+    }
+    if (*x + *width > (int16_t)ST77XX_device->width) *width = ST77XX_device->width - *x;
+    if (*y + *height > (int16_t)ST77XX_device->height) *height = ST77XX_device->height - *y;
+    return *width > 0 && *height > 0;
+}
+
+/*
+ * @brief Draws a packed 1-bpp bitmap from program memory with foreground and background colors.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param bitmap The bitmap in PROGMEM: rows top to bottom, MSB is the leftmost pixel, each row padded to a whole byte.
+ * @param width The width of the bitmap in pixels.
+ * @param height The height of the bitmap in pixels.
+ * @param color The color of set bits.
+ * @param backgroundColor The color of clear bits.
+ *
+ * The visible part of the bitmap is sent as a single address window, with
+ * each bit expanded to RGB565 while it is streamed.
+ */
+void ST77XX_DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint16_t width, uint16_t height, uint16_t color,
+                       uint16_t backgroundColor) {
+    int16_t left = x;
+    int16_t top = y;
+    int16_t visibleWidth = width;
+    int16_t visibleHeight = height;
+    if (!ST77XX_ClipBitmap(&left, &top, &visibleWidth, &visibleHeight)) return;
+
+    uint16_t rowBytes = (width + 7) >> 3;
+    uint16_t column = left - x;
+    const uint8_t *row = bitmap + (uint16_t)(top - y) * rowBytes + (column >> 3);
+    uint8_t colorHigh = color >> 8;
+    uint8_t colorLow = color & 0xFF;
+    uint8_t backgroundHigh = backgroundColor >> 8;
+    uint8_t backgroundLow = backgroundColor & 0xFF;
+
+    ST77XX_SetAddressWindow(left, top, left + visibleWidth - 1, top + visibleHeight - 1);
+
+    // Activate the Chip Select (CS) and select data mode once for the whole bitmap
+    *ST77XX_port &= ~ST77XX_csMask;
+    *ST77XX_port |= ST77XX_dcMask;
+
+    while (visibleHeight--) {
+        const uint8_t *data = row;
+        uint8_t bits = pgm_read_byte(data++) << (column & 7);
+        uint8_t remaining = 8 - (column & 7);
+
+        for (int16_t i = visibleWidth; i > 0; i--) {
+            if (remaining == 0) {
+                bits = pgm_read_byte(data++);
+                remaining = 8;
+            }
+            if (bits & 0x80) {
+                ST77XX_Transmit(colorHigh);
+                ST77XX_Transmit(colorLow);
+            } else {
+                ST77XX_Transmit(backgroundHigh);
+                ST77XX_Transmit(backgroundLow);
+            }
+            bits <<= 1;
+            remaining--;
+        }
+        row += rowBytes;
+    }
+
+    // Deactivate the Chip Select (CS) of the display
+    *ST77XX_port |= ST77XX_csMask;
+}
+
+/*
+ * @brief Draws the set bits of a packed 1-bpp bitmap from program memory, leaving clear bits untouched.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param bitmap The bitmap in PROGMEM, in the same format as for ST77XX_DrawBitmap.
+ * @param width The width of the bitmap in pixels.
+ * @param height The height of the bitmap in pixels.
+ * @param color The color of set bits.
+ *
+ * Each horizontal run of set bits is filled as one address window.
+ */
+void ST77XX_DrawBitmapTransparent(int16_t x, int16_t y, const uint8_t *bitmap, uint16_t width, uint16_t height,
+                                  uint16_t color) {
+    int16_t left = x;
+    int16_t top = y;
+    int16_t visibleWidth = width;
+    int16_t visibleHeight = height;
+    if (!ST77XX_ClipBitmap(&left, &top, &visibleWidth, &visibleHeight)) return;
+
+    uint16_t rowBytes = (width + 7) >> 3;
+    uint16_t column = left - x;
+    const uint8_t *row = bitmap + (uint16_t)(top - y) * rowBytes + (column >> 3);
+
+    for (int16_t py = top; py < top + visibleHeight; py++) {
+        const uint8_t *data = row;
+        uint8_t bits = pgm_read_byte(data++) << (column & 7);
+        uint8_t remaining = 8 - (column & 7);
+        int16_t runStart = -1;
+
+        for (int16_t px = left; px < left + visibleWidth; px++) {
+            if (remaining == 0) {
+                bits = pgm_read_byte(data++);
+                remaining = 8;
+            }
+            if (bits & 0x80) {
+                if (runStart < 0) runStart = px;
+            } else if (runStart >= 0) {
+                // The run ended; the row range stays cached, so only CASET is resent
+                ST77XX_SetAddressWindowOrdered(runStart, py, px - 1, py, ST77XX_ORDER_ANY);
+                ST77XX_WriteColor(color, px - runStart);
+                runStart = -1;
+            }
+            bits <<= 1;
+            remaining--;
+        }
+        if (runStart >= 0) {
+            ST77XX_SetAddressWindowOrdered(runStart, py, left + visibleWidth - 1, py, ST77XX_ORDER_ANY);
+            ST77XX_WriteColor(color, left + visibleWidth - runStart);
+        }
+        row += rowBytes;
+    }
+}
+
 /*
  * @brief Fills the entire ST77XX display with a specified color.
  *
@@ -301,23 +1027,252 @@ int16_t ST77XX_DrawString(uint16_t x, uint16_t y, char *str, int16_t textColor,
  * to the display memory.
  */
 void ST77XX_FillScreenWithColor(uint16_t color) {
-    ST77XX_SendCommand(ST77XX_CASET);  // Column address set
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(ST77XX_DISPLAY_X_OFFSET);
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(ST77XX_DISPLAY_WIDTH + ST77XX_DISPLAY_X_OFFSET);
+    ST77XX_SetAddressWindowOrdered(0, 0, ST77XX_device->width - 1, ST77XX_device->height - 1, ST77XX_ORDER_ANY);
+    ST77XX_WriteColor(color, (uint32_t)ST77XX_device->width * (uint32_t)ST77XX_device->height);
+}
+
+/*
+ * @brief Defines the vertical scrolling area.
+ *
+ * @param topFixed Number of frame memory rows above the scrolling area.
+ * @param scrollRows Number of frame memory rows in the scrolling area.
+ *
+ * The rows below the scrolling area make up the rest of ST77XX_MEMORY_ROWS.
+ */
+void ST77XX_SetScrollArea(uint16_t topFixed, uint16_t scrollRows) {
+    uint16_t bottomFixed = ST77XX_MEMORY_ROWS - topFixed - scrollRows;
+
+    ST77XX_SendCommand(ST77XX_SCRLAR);
+    ST77XX_SendData(topFixed >> 8);  // Top fixed area
+    ST77XX_SendData(topFixed & 0xFF);
+    ST77XX_SendData(scrollRows >> 8);  // Vertical scrolling area
+    ST77XX_SendData(scrollRows & 0xFF);
+    ST77XX_SendData(bottomFixed >> 8);  // Bottom fixed area
+    ST77XX_SendData(bottomFixed & 0xFF);
+}
+
+/*
+ * @brief Sets the frame memory row shown at the top of the scrolling area.
+ *
+ * @param row The frame memory row, between topFixed and topFixed + scrollRows - 1.
+ */
+void ST77XX_SetScrollStart(uint16_t row) {
+    ST77XX_SendCommand(ST77XX_VSCSAD);
+    ST77XX_SendData(row >> 8);
+    ST77XX_SendData(row & 0xFF);
+}
+
+/*
+ * @brief Tells whether frame memory rows run horizontally in the current orientation.
+ *
+ * @return 1 if the scrolling axis is the x axis, 0 if it is the y axis.
+ */
+uint8_t ST77XX_IsScrollAxisHorizontal(void) { return (ST77XX_device->madctl & ST77XX_MADCTL_MV) ? 1 : 0; }
+
+/*
+ * @brief Converts a frame memory row to a coordinate in the current orientation.
+ *
+ * @param row The frame memory row.
+ * @return The x-coordinate (horizontal scrolling axis) or y-coordinate (vertical scrolling axis) showing the row.
+ */
+int16_t ST77XX_MemoryRowToCoordinate(uint16_t row) {
+    // Undo the row mirroring, then the offset of the axis that addresses memory rows
+    uint16_t address = (ST77XX_device->madctl & ST77XX_MADCTL_MY) ? ST77XX_MEMORY_ROWS - 1 - row : row;
+    return address - ((ST77XX_device->madctl & ST77XX_MADCTL_MV) ? ST77XX_device->xOffset : ST77XX_device->yOffset);
+}
+
+/*
+ * @brief Sets the frame memory rows scanned in partial mode.
+ *
+ * @param startRow The first scanned row, counted from the top of the native orientation.
+ * @param endRow The last scanned row (inclusive); may be above startRow to wrap around the bottom.
+ *
+ * Rows outside the range are not refreshed while partial mode is on, so
+ * drawing there can be skipped until normal mode is restored.
+ */
+void ST77XX_SetPartialArea(uint16_t startRow, uint16_t endRow) {
+    startRow += ST77XX_DISPLAY_Y_OFFSET;
+    endRow += ST77XX_DISPLAY_Y_OFFSET;
+
+    ST77XX_SendCommand(ST77XX_PTLAR);
+    ST77XX_SendData(startRow >> 8);
+    ST77XX_SendData(startRow & 0xFF);
+    ST77XX_SendData(endRow >> 8);
+    ST77XX_SendData(endRow & 0xFF);
+}
+
+/*
+ * @brief Switches between partial mode (PTLON) and normal mode (NORON).
+ *
+ * @param enabled 1 to scan only the partial area, 0 to scan the whole panel.
+ */
+void ST77XX_SetPartialMode(uint8_t enabled) { ST77XX_SendCommand(enabled ? ST77XX_PTLON : ST77XX_NORON); }
+
+/*
+ * @brief Switches idle mode (IDMON/IDMOFF), which shows 8 colors to save power.
+ *
+ * @param enabled 1 to enter idle mode, 0 to leave it.
+ */
+void ST77XX_SetIdleMode(uint8_t enabled) { ST77XX_SendCommand(enabled ? ST77XX_IDMON : ST77XX_IDMOFF); }
+
+/*
+ * @brief Starts a read command on the selected panel at the read clock rate.
+ *
+ * @param command The read command.
+ *
+ * The chip select stays low until ST77XX_EndRead.
+ */
+static void ST77XX_BeginRead(uint8_t command) {
+    SPI_MasterInit(ST77XX_READ_PRESCALER);
+    *ST77XX_port &= ~ST77XX_csMask;
+    *ST77XX_port &= ~ST77XX_dcMask;
+    ST77XX_Transfer(command);
+    *ST77XX_port |= ST77XX_dcMask;
+}
 
-    ST77XX_SendCommand(ST77XX_RASET);  // Row address set
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(ST77XX_DISPLAY_Y_OFFSET);  // Start row
-    ST77XX_SendData(0x00);
-    ST77XX_SendData(ST77XX_DISPLAY_HEIGHT + ST77XX_DISPLAY_Y_OFFSET);
+/*
+ * @brief Ends a read command and restores the write clock rate.
+ */
+static void ST77XX_EndRead(void) {
+    *ST77XX_port |= ST77XX_csMask;
+    SPI_MasterInit(2);
+}
 
-    ST77XX_SendCommand(ST77XX_RAMWR);  // Memory write
-    for (uint32_t i = 0; i < ((uint32_t)ST77XX_DISPLAY_WIDTH * (uint32_t)ST77XX_DISPLAY_HEIGHT); i++) {
-        ST77XX_SendData(color >> 8);    // Send the most significant byte of the color
-        ST77XX_SendData(color & 0xFF);  // Send the least significant byte of the color
+/*
+ * @brief Tells whether pixels can be read back from the selected panel.
+ *
+ * @return 1 if the panel answers on MISO, 0 otherwise.
+ *
+ * The first call after ST77XX_InitDisplay probes the panel by reading its
+ * power mode (RDDPM); a panel without MISO reads as all ones or all zeros.
+ */
+uint8_t ST77XX_CanRead(void) {
+    ST77XX_Device *device = ST77XX_device;
+
+    // Several selected panels would drive MISO against each other
+    if (ST77XX_csMask & (ST77XX_csMask - 1)) return 0;
+
+    if (device->readBack == ST77XX_READBACK_UNKNOWN) {
+        // Pull MISO up so an unconnected line reads as all ones
+        DDR_SPI &= ~(1 << DD_MISO);
+        PORT_SPI |= (1 << DD_MISO);
+
+        ST77XX_BeginRead(ST77XX_RDDPM);
+        uint8_t powerMode = ST77XX_Transfer(0x00);
+        ST77XX_EndRead();
+
+        device->readBack = (powerMode == 0x00 || powerMode == 0xFF) ? ST77XX_READBACK_UNAVAILABLE
+                                                                    : ST77XX_READBACK_AVAILABLE;
     }
+    return device->readBack == ST77XX_READBACK_AVAILABLE;
+}
+
+/*
+ * @brief Reads a window of pixels back from frame memory (RAMRD).
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param width The width of the window.
+ * @param height The height of the window.
+ * @param pixels Buffer receiving width * height RGB565 pixels in row-major order.
+ * @return 1 on success, 0 if the window is not fully on screen or the panel cannot be read.
+ */
+uint8_t ST77XX_ReadPixels(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t *pixels) {
+    if (x < 0 || y < 0 || width <= 0 || height <= 0) return 0;
+    if (x + width > (int16_t)ST77XX_device->width || y + height > (int16_t)ST77XX_device->height) return 0;
+    if (!ST77XX_CanRead()) return 0;
+
+    ST77XX_ProgramWindow(x, y, x + width - 1, y + height - 1, ST77XX_ORDER_ROW_MAJOR);
+    ST77XX_BeginRead(ST77XX_RAMRD);
+    ST77XX_Transfer(0x00);  // Dummy byte
+
+    // Frame memory is always read as 18-bit color: one byte per channel, left-aligned
+    for (uint16_t count = (uint16_t)width * height; count > 0; count--) {
+        uint8_t red = ST77XX_Transfer(0x00);
+        uint8_t green = ST77XX_Transfer(0x00);
+        uint8_t blue = ST77XX_Transfer(0x00);
+        *pixels++ = ((uint16_t)(red & 0xF8) << 8) | ((uint16_t)(green & 0xFC) << 3) | (blue >> 3);
+    }
+
+    ST77XX_EndRead();
+    return 1;
+}
+
+/*
+ * @brief Blends two RGB565 colors.
+ *
+ * @param color The foreground color.
+ * @param background The background color.
+ * @param alpha The weight of the foreground, from 0 to 32.
+ * @return The blended color.
+ *
+ * Spreading the channels apart (00000GGGGGG00000RRRRR000000BBBBB) leaves room
+ * for all three products, so one multiplication blends the whole pixel.
+ */
+static uint16_t ST77XX_Blend(uint16_t color, uint16_t background, uint8_t alpha) {
+    uint32_t foreground = (color | ((uint32_t)color << 16)) & 0x07E0F81FUL;
+    uint32_t backdrop = (background | ((uint32_t)background << 16)) & 0x07E0F81FUL;
+    uint32_t result = ((((foreground - backdrop) * alpha) >> 5) + backdrop) & 0x07E0F81FUL;
+    return (uint16_t)(result | (result >> 16));
+}
+
+/*
+ * @brief Blends a color over a rectangle of existing content.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param width The width of the rectangle.
+ * @param height The height of the rectangle.
+ * @param color The color to blend in.
+ * @param alpha The opacity of the color, from 0 (invisible) to 255 (opaque).
+ * @return 1 on success, 0 if the panel cannot be read.
+ *
+ * The rectangle is read back, blended and written again in short row chunks.
+ */
+uint8_t ST77XX_BlendRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color, uint8_t alpha) {
+    uint16_t pixels[32];
+    uint8_t weight = (alpha + 4) >> 3;
+
+    if (!ST77XX_CanRead()) return 0;
+    if (x < 0) {
+        width += x;
+        x = 0;
+    }
+    if (y < 0) {
+        height += y;
+        y = 0;
+    }
+    if (x + width > (int16_t)ST77XX_device->width) width = ST77XX_device->width - x;
+    if (y + height > (int16_t)ST77XX_device->height) height = ST77XX_device->height - y;
+
+    for (int16_t row = y; row < y + height; row++) {
+        for (int16_t column = x; column < x + width; column += 32) {
+            int16_t count = x + width - column;
+            if (count > 32) count = 32;
+
+            if (!ST77XX_ReadPixels(column, row, count, 1, pixels)) return 0;
+            for (int16_t i = 0; i < count; i++) {
+                pixels[i] = ST77XX_Blend(color, pixels[i], weight);
+            }
+            ST77XX_SetAddressWindow(column, row, column + count - 1, row);
+            ST77XX_WritePixels(pixels, count);
+        }
+    }
+    return 1;
+}
+
+/*
+ * @brief Copies and clears the drawing counters.
+ *
+ * @param stats Receives the counters collected since the previous call; all zero without ST77XX_STATS.
+ */
+void ST77XX_TakeStats(ST77XX_Stats *stats) {
+#ifdef ST77XX_STATS
+    *stats = ST77XX_stats;
+    memset(&ST77XX_stats, 0, sizeof(ST77XX_stats));
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
 }
 
 /*
@@ -357,11 +1312,7 @@ void ST77XX_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t co
  * @param w Width of the line.
  * @param color Color of the line.
  */
-void ST77XX_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
-    for (int16_t i = x; i < x + w; i++) {
-        ST77XX_DrawPixel(i, y, color);
-    }
-}
+void ST77XX_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { ST77XX_FillRect(x, y, w, 1, color); }
 
 /*
  * @brief Draw a vertical line on the display.
@@ -371,11 +1322,7 @@ void ST77XX_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
  * @param h Height of the line.
  * @param color Color of the line.
  */
-void ST77XX_DrawVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
-    for (int16_t i = y; i < y + h; i++) {
-        ST77XX_DrawPixel(x, i, color);
-    }
-}
+void ST77XX_DrawVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { ST77XX_FillRect(x, y, 1, h, color); }
 
 /*
  * @brief Draw a diagonal line on the display.
@@ -422,11 +1369,150 @@ void ST77XX_DrawRect(int x, int y, int width, int height, uint16_t color) {
  * @param color Color of the rectangle.
  */
 void ST77XX_FillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color) {
-    for (int16_t i = x; i < x + width; i++) {
-        for (int16_t j = y; j < y + height; j++) {
-            ST77XX_DrawPixel(i, j, color);
+    // Clip the rectangle against the display bounds
+    if (x < 0) {
+        width += x;
+        x = 0;
+    }
+    if (y < 0) {
+        height += y;
+        y = 0;
+    }
+    if (x + width > (int16_t)ST77XX_device->width) width = ST77XX_device->width - x;
+    if (y + height > (int16_t)ST77XX_device->height) height = ST77XX_device->height - y;
+    if (width <= 0 || height <= 0) return;
+
+    // Fill the whole rectangle as a single address window; a solid fill works in either streaming order
+    ST77XX_SetAddressWindowOrdered(x, y, x + width - 1, y + height - 1, ST77XX_ORDER_ANY);
+    ST77XX_WriteColor(color, (uint32_t)width * (uint32_t)height);
+}
+
+/*
+ * @brief 4x4 Bayer matrix, as thresholds in 1/256 of a color level.
+ */
+static const uint8_t ST77XX_DITHER[4][4] PROGMEM = {
+    {0, 128, 32, 160},
+    {192, 64, 224, 96},
+    {48, 176, 16, 144},
+    {240, 112, 208, 80},
+};
+
+/*
+ * @brief A color channel stepped in 8.8 fixed point.
+ */
+typedef struct {
+    int16_t level;  // Current level, in 1/256 of a color level
+    int16_t step;   // Change per pixel along the gradient
+} ST77XX_Channel;
+
+/*
+ * @brief Prepares a channel to step from one level to another over a number of pixels.
+ *
+ * @param channel The channel to prepare.
+ * @param start The level at the first pixel.
+ * @param end The level at the last pixel.
+ * @param length The number of pixels along the gradient.
+ */
+static void ST77XX_InitChannel(ST77XX_Channel *channel, uint8_t start, uint8_t end, int16_t length) {
+    channel->level = (int16_t)start << 8;
+    // Truncating toward zero keeps the last pixel from stepping past the end level
+    channel->step = (length > 1) ? (((int16_t)end - start) << 8) / (length - 1) : 0;
+}
+
+/*
+ * @brief Builds a dithered RGB565 color from three channels.
+ *
+ * @param red The red channel.
+ * @param green The green channel.
+ * @param blue The blue channel.
+ * @param threshold The dither threshold of the pixel.
+ * @return The RGB565 color.
+ */
+static inline uint16_t ST77XX_DitherColor(const ST77XX_Channel *red, const ST77XX_Channel *green,
+                                          const ST77XX_Channel *blue, uint8_t threshold) {
+    uint8_t r = (uint16_t)(red->level + threshold) >> 8;
+    uint8_t g = (uint16_t)(green->level + threshold) >> 8;
+    uint8_t b = (uint16_t)(blue->level + threshold) >> 8;
+    return ((uint16_t)r << 11) | ((uint16_t)g << 5) | b;
+}
+
+/*
+ * @brief Fill a rectangle with a dithered linear gradient.
+ *
+ * @param x Top-left x-coordinate.
+ * @param y Top-left y-coordinate.
+ * @param width Width of the rectangle.
+ * @param height Height of the rectangle.
+ * @param startColor Color at the left (horizontal) or top (vertical) edge.
+ * @param endColor Color at the right (horizontal) or bottom (vertical) edge.
+ * @param direction ST77XX_GRADIENT_HORIZONTAL or ST77XX_GRADIENT_VERTICAL.
+ */
+void ST77XX_FillGradient(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t startColor, uint16_t endColor,
+                         uint8_t direction) {
+    int16_t length = (direction == ST77XX_GRADIENT_VERTICAL) ? height : width;
+    ST77XX_Channel red, green, blue;
+    ST77XX_InitChannel(&red, startColor >> 11, endColor >> 11, length);
+    ST77XX_InitChannel(&green, (startColor >> 5) & 0x3F, (endColor >> 5) & 0x3F, length);
+    ST77XX_InitChannel(&blue, startColor & 0x1F, endColor & 0x1F, length);
+
+    // Clip, then advance the channels past the hidden part of the gradient
+    int16_t skipX = (x < 0) ? -x : 0;
+    int16_t skipY = (y < 0) ? -y : 0;
+    x += skipX;
+    y += skipY;
+    width -= skipX;
+    height -= skipY;
+    if (x + width > (int16_t)ST77XX_device->width) width = ST77XX_device->width - x;
+    if (y + height > (int16_t)ST77XX_device->height) height = ST77XX_device->height - y;
+    if (width <= 0 || height <= 0) return;
+
+    int16_t skip = (direction == ST77XX_GRADIENT_VERTICAL) ? skipY : skipX;
+    red.level += (int32_t)red.step * skip;
+    green.level += (int32_t)green.step * skip;
+    blue.level += (int32_t)blue.step * skip;
+
+    // One window for the whole rectangle
+    ST77XX_SetAddressWindow(x, y, x + width - 1, y + height - 1);
+    *ST77XX_port &= ~ST77XX_csMask;
+    *ST77XX_port |= ST77XX_dcMask;
+
+    if (direction == ST77XX_GRADIENT_VERTICAL) {
+        for (int16_t row = y; row < y + height; row++) {
+            // The level only changes per row, so the four dithered colors of the row are built once
+            const uint8_t *thresholds = ST77XX_DITHER[row & 3];
+            uint16_t colors[4];
+            for (uint8_t i = 0; i < 4; i++) {
+                colors[i] = ST77XX_DitherColor(&red, &green, &blue, pgm_read_byte(&thresholds[i]));
+            }
+            for (int16_t column = x; column < x + width; column++) {
+                uint16_t color = colors[column & 3];
+                ST77XX_Transmit(color >> 8);
+                ST77XX_Transmit(color & 0xFF);
+            }
+            red.level += red.step;
+            green.level += green.step;
+            blue.level += blue.step;
+        }
+    } else {
+        ST77XX_Channel rowRed = red, rowGreen = green, rowBlue = blue;
+        for (int16_t row = y; row < y + height; row++) {
+            const uint8_t *thresholds = ST77XX_DITHER[row & 3];
+            red = rowRed;
+            green = rowGreen;
+            blue = rowBlue;
+            for (int16_t column = x; column < x + width; column++) {
+                uint16_t color = ST77XX_DitherColor(&red, &green, &blue, pgm_read_byte(&thresholds[column & 3]));
+                ST77XX_Transmit(color >> 8);
+                ST77XX_Transmit(color & 0xFF);
+                red.level += red.step;
+                green.level += green.step;
+                blue.level += blue.step;
+            }
         }
     }
+
+    // Deactivate the Chip Select (CS) of the display
+    *ST77XX_port |= ST77XX_csMask;
 }
 
 /*
@@ -13,7 +13,9 @@
 #include <util/delay.h>
 
 #include "glcdfont.h"
+#include "st77xx_panels.h"
 
+// Control pins of the default panel, used until ST77XX_Acquire selects another device
 #define ST77XX_DDR DDRB
 #define ST77XX_PORT PORTB
 
@@ -22,6 +24,19 @@
 #define ST77XX_DD_DC PB2   // Data/command pin
 #define ST77XX_DD_RES PB3  // Reset pin
 
+#ifdef ST77XX_PANEL
+/*
+ * @brief Panel profile selected at compile time (see st77xx_panels.h).
+ */
+typedef ST77XX_PANEL ST77XX_Panel;
+
+#define ST77XX_DISPLAY_WIDTH ((uint16_t)ST77XX_Panel::width)
+#define ST77XX_DISPLAY_HEIGHT ((uint16_t)ST77XX_Panel::height)
+#define ST77XX_DISPLAY_X_OFFSET ((uint16_t)ST77XX_Panel::xOffset)
+#define ST77XX_DISPLAY_Y_OFFSET ((uint16_t)ST77XX_Panel::yOffset)
+#define ST77XX_MEMORY_COLUMNS ((uint16_t)ST77XX_Panel::memoryColumns)
+#define ST77XX_MEMORY_ROWS ((uint16_t)ST77XX_Panel::memoryRows)
+#else
 #ifndef ST77XX_DISPLAY_WIDTH
 #define ST77XX_DISPLAY_WIDTH 240
 #endif
@@ -38,6 +53,96 @@
 #define ST77XX_DISPLAY_Y_OFFSET 0
 #endif
 
+// Number of frame memory columns (240 for ST7789, 132 for ST7735S)
+#ifndef ST77XX_MEMORY_COLUMNS
+#define ST77XX_MEMORY_COLUMNS 240
+#endif
+
+// Number of frame memory rows, also covered by vertical scrolling (320 for ST7789, 162 for ST7735S)
+#ifndef ST77XX_MEMORY_ROWS
+#define ST77XX_MEMORY_ROWS 320
+#endif
+
+/*
+ * @brief Panel profile built from the ST77XX_DISPLAY_* macros, with the original init script.
+ */
+struct ST77XX_PanelLegacy {
+    enum {
+        width = ST77XX_DISPLAY_WIDTH,
+        height = ST77XX_DISPLAY_HEIGHT,
+        xOffset = ST77XX_DISPLAY_X_OFFSET,
+        yOffset = ST77XX_DISPLAY_Y_OFFSET,
+        memoryColumns = ST77XX_MEMORY_COLUMNS,
+        memoryRows = ST77XX_MEMORY_ROWS
+    };
+    enum { controller = ST77XX_CONTROLLER_ST7735S, colorOrder = 0x00, inversion = 1, colorMode = 0x65 };
+#if ST77XX_MEMORY_COLUMNS <= 256 && ST77XX_MEMORY_ROWS <= 256
+    typedef uint8_t Coordinate;
+#else
+    typedef uint16_t Coordinate;
+#endif
+};
+
+typedef ST77XX_PanelLegacy ST77XX_Panel;
+#endif
+
+/*
+ * @brief Coordinate type of the selected panel: 8-bit when all of frame memory is addressable with one byte.
+ */
+typedef ST77XX_Panel::Coordinate ST77XX_Coordinate;
+
+// Parts of the cached address window that the panel currently holds
+#define ST77XX_WINDOW_COLUMNS 0x01
+#define ST77XX_WINDOW_ROWS 0x02
+
+// Whether pixels can be read back from a panel (panels without MISO cannot)
+#define ST77XX_READBACK_UNKNOWN 0
+#define ST77XX_READBACK_AVAILABLE 1
+#define ST77XX_READBACK_UNAVAILABLE 2
+
+/*
+ * @brief Drawing counters, collected when the driver is built with ST77XX_STATS defined.
+ */
+typedef struct {
+    uint32_t bytes;    // Bytes exchanged over SPI, commands and reads included
+    uint16_t windows;  // Address windows opened
+    uint16_t pixels;   // Calls to ST77XX_DrawPixel
+} ST77XX_Stats;
+
+// SPI prescaler used while reading; the controllers' read cycle is slower than their write cycle
+#ifndef ST77XX_READ_PRESCALER
+#define ST77XX_READ_PRESCALER 4
+#endif
+
+/*
+ * @brief An ST77XX panel sharing the SPI bus with other panels.
+ *
+ * All control pins of a panel sit on one port. Panels share the compile-time
+ * profile, but each keeps its own orientation and cached address window, so
+ * CASET/RASET are skipped when a window repeats the range already programmed.
+ */
+typedef struct {
+    volatile uint8_t *port;  // Port of the control pins
+    volatile uint8_t *ddr;   // Data direction register of the control pins
+    uint8_t cs;              // Chip select pin
+    uint8_t dc;              // Data/command pin
+    uint8_t res;             // Reset pin
+    uint8_t blk;             // Backlight pin
+
+    ST77XX_Coordinate width;        // Width in the current orientation
+    ST77XX_Coordinate height;       // Height in the current orientation
+    ST77XX_Coordinate xOffset;      // Frame memory offset of x in the current orientation
+    ST77XX_Coordinate yOffset;      // Frame memory offset of y in the current orientation
+    uint8_t madctl;                 // MADCTL value of the current orientation
+    uint8_t addressOrder;           // Order the panel currently streams in
+    uint8_t window;                 // ST77XX_WINDOW_* bits of the valid cached ranges
+    ST77XX_Coordinate columnStart;  // Cached CASET start
+    ST77XX_Coordinate columnEnd;    // Cached CASET end
+    ST77XX_Coordinate rowStart;     // Cached RASET start
+    ST77XX_Coordinate rowEnd;       // Cached RASET end
+    uint8_t readBack;               // ST77XX_READBACK_* state of the panel
+} ST77XX_Device;
+
 // ST77XX System Function Command List and Description
 #define ST77XX_NOP 0x00         // No Operation
 #define ST77XX_SWRESET 0x01     // Software Reset
@@ -76,6 +181,48 @@
 #define ST77XX_RDID2 0xDB       // Read ID2
 #define ST77XX_RDID3 0xDC       // Read ID3
 
+// ST77XX Memory Data Access Control (MADCTL) bits
+#define ST77XX_MADCTL_MY 0x80   // Row address order (mirrors frame memory rows)
+#define ST77XX_MADCTL_MX 0x40   // Column address order (mirrors frame memory columns)
+#define ST77XX_MADCTL_MV 0x20   // Row/column exchange
+#define ST77XX_MADCTL_ML 0x10   // Vertical refresh order
+#define ST77XX_MADCTL_BGR 0x08  // BGR color order
+#define ST77XX_MADCTL_MH 0x04   // Horizontal refresh order
+
+// Orientation mirroring flags
+#define ST77XX_MIRROR_NONE 0x00
+#define ST77XX_MIRROR_X 0x01  // Mirror left/right in the rotated view
+#define ST77XX_MIRROR_Y 0x02  // Mirror top/bottom in the rotated view
+
+// Address window streaming orders
+#define ST77XX_ORDER_ROW_MAJOR 0     // Pixels fill each row left to right, then move down
+#define ST77XX_ORDER_COLUMN_MAJOR 1  // Pixels fill each column top to bottom, then move right
+#define ST77XX_ORDER_ANY 2           // Keep whichever order the panel is in (solid fills, single lines)
+#define ST77XX_ORDER_UNKNOWN 3       // Device state only: the next window resends MADCTL
+
+// Gradient directions
+#define ST77XX_GRADIENT_HORIZONTAL 0  // Color changes from left to right
+#define ST77XX_GRADIENT_VERTICAL 1    // Color changes from top to bottom
+
+// constexpr needs C++11; older dialects still fold the call when its arguments are constants
+#if __cplusplus >= 201103L
+#define ST77XX_CONSTEXPR constexpr
+#else
+#define ST77XX_CONSTEXPR
+#endif
+
+/*
+ * @brief Converts an RGB888 color to RGB565.
+ *
+ * @param red The red component (0 to 255).
+ * @param green The green component (0 to 255).
+ * @param blue The blue component (0 to 255).
+ * @return The RGB565 color.
+ */
+static inline ST77XX_CONSTEXPR uint16_t ST77XX_Color565(uint8_t red, uint8_t green, uint8_t blue) {
+    return ((uint16_t)(red & 0xF8) << 8) | ((uint16_t)(green & 0xFC) << 3) | (blue >> 3);
+}
+
 // ST77XX Panel Function Command List and Description
 #define ST77XX_FRMCTR1 0xB1   // In Normal Mode (Full Colors)
 #define ST77XX_FRMCTR2 0xB2   // In Idle Mode (8-colors)
@@ -97,6 +244,52 @@
 #define ST77XX_GAMCTRN1 0xE1  // Set Gamma Adjustment (- Polarity)
 #define ST77XX_GCV 0xFC       // Gate Pump Clock Frequency Variable
 
+/*
+ * @brief Describes a panel on the shared SPI bus.
+ *
+ * @param device The device to initialize.
+ * @param port The port of the control pins (e.g. &PORTD).
+ * @param ddr The data direction register of the control pins (e.g. &DDRD).
+ * @param cs The chip select pin.
+ * @param dc The data/command pin.
+ * @param res The reset pin.
+ * @param blk The backlight pin.
+ *
+ * This function drives the chip select high at once, so the panel ignores
+ * traffic meant for other panels until it is acquired and initialized.
+ */
+void ST77XX_InitDevice(ST77XX_Device *device, volatile uint8_t *port, volatile uint8_t *ddr, uint8_t cs, uint8_t dc,
+                       uint8_t res, uint8_t blk);
+
+/*
+ * @brief Takes the bus and makes a device the target of all drawing functions.
+ *
+ * @param device The device to select.
+ * @return 1 if the bus was taken, 0 if another device holds it.
+ */
+uint8_t ST77XX_Acquire(ST77XX_Device *device);
+
+/*
+ * @brief Takes the bus and selects several devices at once, so they receive the same commands and pixels.
+ *
+ * @param devices The devices to select; all must use the same port.
+ * @param count The number of devices.
+ * @return 1 if the bus was taken, 0 if another device holds it or the devices are on different ports.
+ *
+ * Clipping and offsets follow the first device, so every member should share
+ * its orientation. Reset and initialization only address the first device.
+ * The devices array must stay valid until ST77XX_Release.
+ */
+uint8_t ST77XX_AcquireBroadcast(ST77XX_Device *const *devices, uint8_t count);
+
+/*
+ * @brief Releases the bus and selects the default panel again.
+ *
+ * After a broadcast, every member takes on the streaming order the first one
+ * was left in, since they all received the same MADCTL commands.
+ */
+void ST77XX_Release(void);
+
 /*
  * @brief Sends data to the ST77XX display.
  *
@@ -130,6 +323,116 @@ void ST77XX_Reset();
  */
 void ST77XX_InitDisplay();
 
+/*
+ * @brief Callback invoked when a non-blocking initialization completes.
+ */
+typedef void (*ST77XX_InitCallback)(void);
+
+/*
+ * @brief Starts a non-blocking reset and initialization of the selected panel.
+ *
+ * @param callback Function called from ST77XX_InitTick once the panel is ready, or NULL to poll instead.
+ *
+ * The sequence is the one ST77XX_InitDisplay runs, but every delay is counted
+ * in calls to ST77XX_InitTick instead of spent busy-waiting. The panel must stay
+ * selected until the sequence completes; ticks are ignored while another
+ * device is selected.
+ */
+void ST77XX_StartInit(ST77XX_InitCallback callback);
+
+/*
+ * @brief Advances the non-blocking initialization; call once per millisecond.
+ *
+ * @return 1 once the panel is ready, 0 while the sequence is still running or not started.
+ *
+ * Call it from the main loop when a timer flags a millisecond, or from the
+ * timer interrupt itself as long as nothing else uses the bus meanwhile.
+ */
+uint8_t ST77XX_InitTick(void);
+
+/*
+ * @brief Tells whether the last non-blocking initialization has completed.
+ *
+ * @return 1 if the panel is ready, 0 otherwise.
+ */
+uint8_t ST77XX_IsInitDone(void);
+
+/*
+ * @brief Sets the display orientation by programming MADCTL.
+ *
+ * @param rotation The clockwise rotation in quarter turns (0 to 3) from the panel's native orientation.
+ * @param mirror A combination of ST77XX_MIRROR_X and ST77XX_MIRROR_Y applied to the rotated view.
+ *
+ * This function updates the width, height and offsets used by every drawing
+ * primitive, so coordinates always refer to the rotated view.
+ */
+void ST77XX_SetOrientation(uint8_t rotation, uint8_t mirror);
+
+/*
+ * @brief Returns the width of the display in the current orientation.
+ *
+ * @return The width in pixels.
+ */
+uint16_t ST77XX_GetWidth(void);
+
+/*
+ * @brief Returns the height of the display in the current orientation.
+ *
+ * @return The height in pixels.
+ */
+uint16_t ST77XX_GetHeight(void);
+
+/*
+ * @brief Sets the address window for subsequent pixel data.
+ *
+ * @param x0 The first column of the window.
+ * @param y0 The first row of the window.
+ * @param x1 The last column of the window (inclusive).
+ * @param y1 The last row of the window (inclusive).
+ *
+ * This function programs the column and row address ranges and issues the
+ * memory write command, so the display is ready to receive
+ * (x1 - x0 + 1) * (y1 - y0 + 1) pixels in row-major order.
+ */
+void ST77XX_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+/*
+ * @brief Sets the address window, streaming pixels in the requested order.
+ *
+ * @param x0 The first column of the window.
+ * @param y0 The first row of the window.
+ * @param x1 The last column of the window (inclusive).
+ * @param y1 The last row of the window (inclusive).
+ * @param order ST77XX_ORDER_ROW_MAJOR, ST77XX_ORDER_COLUMN_MAJOR or ST77XX_ORDER_ANY.
+ *
+ * Column-major order exchanges rows and columns in MADCTL for as long as it is
+ * needed, which lets column-oriented data such as font glyphs stream as one
+ * window. MADCTL is only resent when the order actually changes.
+ */
+void ST77XX_SetAddressWindowOrdered(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t order);
+
+/*
+ * @brief Streams a single color into the current address window.
+ *
+ * @param color The color to be written.
+ * @param count The number of pixels to write.
+ *
+ * This function keeps the Chip Select (CS) low and the Data/Command (DC) pin
+ * high for the whole run, instead of toggling them for every byte.
+ */
+void ST77XX_WriteColor(uint16_t color, uint32_t count);
+
+/*
+ * @brief Streams a buffer of pixels into the current address window.
+ *
+ * @param pixels The RGB565 pixels to be written.
+ * @param count The number of pixels to write.
+ *
+ * Like ST77XX_WriteColor, this function keeps the Chip Select (CS) low for the
+ * whole buffer.
+ */
+void ST77XX_WritePixels(const uint16_t *pixels, uint16_t count);
+
 /*
  * @brief Draws a pixel on the ST77XX display.
  *
@@ -173,6 +476,38 @@ void ST77XX_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t ba
  */
 int16_t ST77XX_DrawString(uint16_t x, uint16_t y, char *str, int16_t textColor, int16_t backgroundColor);
 
+/*
+ * @brief Draws a packed 1-bpp bitmap from program memory with foreground and background colors.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param bitmap The bitmap in PROGMEM: rows top to bottom, MSB is the leftmost pixel, each row padded to a whole byte.
+ * @param width The width of the bitmap in pixels.
+ * @param height The height of the bitmap in pixels.
+ * @param color The color of set bits.
+ * @param backgroundColor The color of clear bits.
+ *
+ * The visible part of the bitmap is sent as a single address window, with
+ * each bit expanded to RGB565 while it is streamed.
+ */
+void ST77XX_DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint16_t width, uint16_t height, uint16_t color,
+                       uint16_t backgroundColor);
+
+/*
+ * @brief Draws the set bits of a packed 1-bpp bitmap from program memory, leaving clear bits untouched.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param bitmap The bitmap in PROGMEM, in the same format as for ST77XX_DrawBitmap.
+ * @param width The width of the bitmap in pixels.
+ * @param height The height of the bitmap in pixels.
+ * @param color The color of set bits.
+ *
+ * Each horizontal run of set bits is filled as one address window.
+ */
+void ST77XX_DrawBitmapTransparent(int16_t x, int16_t y, const uint8_t *bitmap, uint16_t width, uint16_t height,
+                                  uint16_t color);
+
 /*
  * @brief Fills the entire ST77XX display with a specified color.
  *
@@ -184,6 +519,114 @@ int16_t ST77XX_DrawString(uint16_t x, uint16_t y, char *str, int16_t textColor,
  */
 void ST77XX_FillScreenWithColor(uint16_t color);
 
+/*
+ * @brief Defines the vertical scrolling area.
+ *
+ * @param topFixed Number of frame memory rows above the scrolling area.
+ * @param scrollRows Number of frame memory rows in the scrolling area.
+ *
+ * The rows below the scrolling area make up the rest of ST77XX_MEMORY_ROWS.
+ */
+void ST77XX_SetScrollArea(uint16_t topFixed, uint16_t scrollRows);
+
+/*
+ * @brief Sets the frame memory row shown at the top of the scrolling area.
+ *
+ * @param row The frame memory row, between topFixed and topFixed + scrollRows - 1.
+ */
+void ST77XX_SetScrollStart(uint16_t row);
+
+/*
+ * @brief Tells whether frame memory rows run horizontally in the current orientation.
+ *
+ * @return 1 if the scrolling axis is the x axis, 0 if it is the y axis.
+ */
+uint8_t ST77XX_IsScrollAxisHorizontal(void);
+
+/*
+ * @brief Converts a frame memory row to a coordinate in the current orientation.
+ *
+ * @param row The frame memory row.
+ * @return The x-coordinate (horizontal scrolling axis) or y-coordinate (vertical scrolling axis) showing the row.
+ */
+int16_t ST77XX_MemoryRowToCoordinate(uint16_t row);
+
+/*
+ * @brief Sets the frame memory rows scanned in partial mode.
+ *
+ * @param startRow The first scanned row, counted from the top of the native orientation.
+ * @param endRow The last scanned row (inclusive); may be above startRow to wrap around the bottom.
+ *
+ * Rows outside the range are not refreshed while partial mode is on, so
+ * drawing there can be skipped until normal mode is restored.
+ */
+void ST77XX_SetPartialArea(uint16_t startRow, uint16_t endRow);
+
+/*
+ * @brief Switches between partial mode (PTLON) and normal mode (NORON).
+ *
+ * @param enabled 1 to scan only the partial area, 0 to scan the whole panel.
+ */
+void ST77XX_SetPartialMode(uint8_t enabled);
+
+/*
+ * @brief Switches idle mode (IDMON/IDMOFF), which shows 8 colors to save power.
+ *
+ * @param enabled 1 to enter idle mode, 0 to leave it.
+ *
+ * Together with partial mode this leaves only a status strip scanned, at the
+ * lowest color depth, e.g.
+ *
+ *     ST77XX_SetPartialArea(0, 15);
+ *     ST77XX_SetPartialMode(1);
+ *     ST77XX_SetIdleMode(1);
+ */
+void ST77XX_SetIdleMode(uint8_t enabled);
+
+/*
+ * @brief Tells whether pixels can be read back from the selected panel.
+ *
+ * @return 1 if the panel answers on MISO, 0 otherwise.
+ *
+ * The first call after ST77XX_InitDisplay probes the panel by reading its
+ * power mode (RDDPM); a panel without MISO reads as all ones or all zeros.
+ */
+uint8_t ST77XX_CanRead(void);
+
+/*
+ * @brief Reads a window of pixels back from frame memory (RAMRD).
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param width The width of the window.
+ * @param height The height of the window.
+ * @param pixels Buffer receiving width * height RGB565 pixels in row-major order.
+ * @return 1 on success, 0 if the window is not fully on screen or the panel cannot be read.
+ */
+uint8_t ST77XX_ReadPixels(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t *pixels);
+
+/*
+ * @brief Blends a color over a rectangle of existing content.
+ *
+ * @param x The x-coordinate of the top-left corner.
+ * @param y The y-coordinate of the top-left corner.
+ * @param width The width of the rectangle.
+ * @param height The height of the rectangle.
+ * @param color The color to blend in.
+ * @param alpha The opacity of the color, from 0 (invisible) to 255 (opaque).
+ * @return 1 on success, 0 if the panel cannot be read.
+ *
+ * The rectangle is read back, blended and written again in short row chunks.
+ */
+uint8_t ST77XX_BlendRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color, uint8_t alpha);
+
+/*
+ * @brief Copies and clears the drawing counters.
+ *
+ * @param stats Receives the counters collected since the previous call; all zero without ST77XX_STATS.
+ */
+void ST77XX_TakeStats(ST77XX_Stats *stats);
+
 /*
  * @brief Delays execution for the given number of milliseconds.
  *
@@ -255,6 +698,20 @@ void ST77XX_DrawRect(int x, int y, int width, int height, uint16_t color);
  */
 void ST77XX_FillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color);
 
+/*
+ * @brief Fill a rectangle with a dithered linear gradient.
+ *
+ * @param x Top-left x-coordinate.
+ * @param y Top-left y-coordinate.
+ * @param width Width of the rectangle.
+ * @param height Height of the rectangle.
+ * @param startColor Color at the left (horizontal) or top (vertical) edge.
+ * @param endColor Color at the right (horizontal) or bottom (vertical) edge.
+ * @param direction ST77XX_GRADIENT_HORIZONTAL or ST77XX_GRADIENT_VERTICAL.
+ */
+void ST77XX_FillGradient(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t startColor, uint16_t endColor,
+                         uint8_t direction);
+
 /*
  * @brief Draw a circle on the display.
  *
@@ -0,0 +1,80 @@
+/*
+ * Header guard to prevent multiple inclusions of the "st77xx_panels.h" header file.
+ */
+#ifndef ST77XX_PANELS_H
+#define ST77XX_PANELS_H
+
+#include <stdint.h>
+
+/*
+ * Compile-time panel profiles for the ST77XX driver.
+ *
+ * A profile is a struct whose members are enumerators, so every value folds into
+ * the code that uses it and no profile occupies RAM or flash. Select one by
+ * defining ST77XX_PANEL as the profile name, e.g.
+ *
+ *     -DST77XX_PANEL=ST77XX_PanelST7789_240x320
+ *
+ * Without ST77XX_PANEL, the legacy ST77XX_DISPLAY_* macros describe the panel.
+ *
+ * Members of a profile:
+ *  - width, height: visible area in the native orientation.
+ *  - xOffset, yOffset: position of the visible area in frame memory.
+ *  - memoryColumns, memoryRows: size of the controller's frame memory.
+ *  - controller: ST77XX_CONTROLLER_ST7735S or ST77XX_CONTROLLER_ST7789, selects the init script.
+ *  - colorOrder: 0 for RGB panels, ST77XX_MADCTL_BGR for BGR panels.
+ *  - inversion: 1 if the panel needs INVON to show true colors.
+ *  - colorMode: COLMOD value for 16-bit pixels.
+ *  - Coordinate: uint8_t when all of frame memory is addressable with 8 bits, uint16_t otherwise.
+ */
+
+// Controller families, each with its own init script
+#define ST77XX_CONTROLLER_ST7735S 0
+#define ST77XX_CONTROLLER_ST7789 1
+
+/*
+ * @brief ST7735S, 128x160, full 132x162 frame memory (1.8" black tab modules).
+ */
+struct ST77XX_PanelST7735S_128x160 {
+    enum { width = 128, height = 160, xOffset = 0, yOffset = 0, memoryColumns = 132, memoryRows = 162 };
+    enum { controller = ST77XX_CONTROLLER_ST7735S, colorOrder = 0x00, inversion = 0, colorMode = 0x05 };
+    typedef uint8_t Coordinate;
+};
+
+/*
+ * @brief ST7735S, 80x160, centered in the 132x162 frame memory (0.96" modules).
+ */
+struct ST77XX_PanelST7735S_80x160 {
+    enum { width = 80, height = 160, xOffset = 26, yOffset = 1, memoryColumns = 132, memoryRows = 162 };
+    enum { controller = ST77XX_CONTROLLER_ST7735S, colorOrder = 0x08, inversion = 1, colorMode = 0x05 };
+    typedef uint8_t Coordinate;
+};
+
+/*
+ * @brief ST7789, 240x240 square panels.
+ */
+struct ST77XX_PanelST7789_240x240 {
+    enum { width = 240, height = 240, xOffset = 0, yOffset = 0, memoryColumns = 240, memoryRows = 320 };
+    enum { controller = ST77XX_CONTROLLER_ST7789, colorOrder = 0x00, inversion = 1, colorMode = 0x55 };
+    typedef uint16_t Coordinate;
+};
+
+/*
+ * @brief ST7789, 240x320 panels (320x240 in landscape).
+ */
+struct ST77XX_PanelST7789_240x320 {
+    enum { width = 240, height = 320, xOffset = 0, yOffset = 0, memoryColumns = 240, memoryRows = 320 };
+    enum { controller = ST77XX_CONTROLLER_ST7789, colorOrder = 0x00, inversion = 1, colorMode = 0x55 };
+    typedef uint16_t Coordinate;
+};
+
+/*
+ * @brief ST7789, 135x240 panels (1.14" modules).
+ */
+struct ST77XX_PanelST7789_135x240 {
+    enum { width = 135, height = 240, xOffset = 52, yOffset = 40, memoryColumns = 240, memoryRows = 320 };
+    enum { controller = ST77XX_CONTROLLER_ST7789, colorOrder = 0x00, inversion = 1, colorMode = 0x55 };
+    typedef uint16_t Coordinate;
+};
+
+#endif  // ST77XX_PANELS_H
@@ -0,0 +1,157 @@
+/*
+ * Include the header file for the strip chart.
+ */
+#include "stripchart.h"
+
+#include "../st77xx/st77xx.h"
+
+/*
+ * @brief Maps a sample value to an offset on the value axis.
+ *
+ * @param chart The chart whose scale is used.
+ * @param value The sample value.
+ * @return The offset, between 0 and valueLength - 1.
+ */
+static int16_t STRIPCHART_ValueToColumn(const STRIPCHART_Chart *chart, int16_t value) {
+    if (value <= chart->minValue) return 0;
+    if (value >= chart->maxValue) return chart->valueLength - 1;
+    // Widen before subtracting; the range may exceed int16_t
+    return ((int32_t)value - chart->minValue) * (chart->valueLength - 1) /
+           ((int32_t)chart->maxValue - chart->minValue);
+}
+
+/*
+ * @brief Opens a window covering one memory row of the chart along the value axis.
+ *
+ * @param chart The chart to draw.
+ * @param row The memory row, relative to the start of the scrolling area.
+ * @param length The number of memory rows covered by the window.
+ */
+static void STRIPCHART_SetRowWindow(const STRIPCHART_Chart *chart, uint16_t row, uint16_t length) {
+    int16_t first = ST77XX_MemoryRowToCoordinate(ST77XX_DISPLAY_Y_OFFSET + chart->firstRow + row);
+    int16_t last = ST77XX_MemoryRowToCoordinate(ST77XX_DISPLAY_Y_OFFSET + chart->firstRow + row + length - 1);
+    if (first > last) {
+        int16_t swap = first;
+        first = last;
+        last = swap;
+    }
+
+    int16_t valueEnd = chart->valueStart + chart->valueLength - 1;
+    if (ST77XX_IsScrollAxisHorizontal()) {
+        ST77XX_SetAddressWindowOrdered(first, chart->valueStart, last, valueEnd, ST77XX_ORDER_ANY);
+    } else {
+        ST77XX_SetAddressWindowOrdered(chart->valueStart, first, valueEnd, last, ST77XX_ORDER_ANY);
+    }
+}
+
+/*
+ * @brief Draws the next row of the chart and scrolls it into view.
+ *
+ * @param chart The chart to draw.
+ * @param low First value axis offset of the trace on this row.
+ * @param high Last value axis offset of the trace on this row.
+ */
+static void STRIPCHART_DrawRow(STRIPCHART_Chart *chart, int16_t low, int16_t high) {
+    // One window per row: background, trace span, background
+    STRIPCHART_SetRowWindow(chart, chart->head, 1);
+    ST77XX_WriteColor(chart->backgroundColor, low);
+    ST77XX_WriteColor(chart->traceColor, high - low + 1);
+    ST77XX_WriteColor(chart->backgroundColor, chart->valueLength - 1 - high);
+
+    // Show the row after the new one at the top, so the newest point is at the bottom
+    if (++chart->head == chart->rows) {
+        chart->head = 0;
+    }
+    ST77XX_SetScrollStart(ST77XX_DISPLAY_Y_OFFSET + chart->firstRow + chart->head);
+}
+
+/*
+ * @brief Clears the chart area and sets up the hardware scrolling area.
+ *
+ * @param chart The chart to initialize.
+ */
+void STRIPCHART_Init(STRIPCHART_Chart *chart) {
+    if (chart->samplesPerRow == 0) {
+        chart->samplesPerRow = 1;
+    }
+    chart->head = 0;
+    chart->count = 0;
+    chart->lastColumn = -1;
+    chart->ringHead = 0;
+    chart->ringTail = 0;
+
+    STRIPCHART_SetRowWindow(chart, 0, chart->rows);
+    ST77XX_WriteColor(chart->backgroundColor, (uint32_t)chart->rows * chart->valueLength);
+    ST77XX_SetScrollArea(ST77XX_DISPLAY_Y_OFFSET + chart->firstRow, chart->rows);
+    ST77XX_SetScrollStart(ST77XX_DISPLAY_Y_OFFSET + chart->firstRow);
+}
+
+/*
+ * @brief Queues a sample; safe to call from an interrupt.
+ *
+ * @param chart The chart receiving the sample.
+ * @param value The sample value.
+ * @return 1 if the sample was queued, 0 if the ring buffer was full and the sample was dropped.
+ */
+uint8_t STRIPCHART_Push(STRIPCHART_Chart *chart, int16_t value) {
+    uint8_t head = chart->ringHead;
+    uint8_t next = (head + 1) & (STRIPCHART_RING_SIZE - 1);
+
+    if (next == chart->ringTail) {
+        return 0;
+    }
+    chart->ring[head] = value;
+    chart->ringHead = next;  // Publish the sample only after it is stored
+    return 1;
+}
+
+/*
+ * @brief Plots all queued samples.
+ *
+ * @param chart The chart to update.
+ */
+void STRIPCHART_Update(STRIPCHART_Chart *chart) {
+    uint8_t tail = chart->ringTail;
+
+    while (tail != chart->ringHead) {
+        STRIPCHART_AddSample(chart, chart->ring[tail]);
+        tail = (tail + 1) & (STRIPCHART_RING_SIZE - 1);
+        chart->ringTail = tail;
+    }
+}
+
+/*
+ * @brief Adds a sample directly, bypassing the ring buffer.
+ *
+ * @param chart The chart receiving the sample.
+ * @param value The sample value.
+ */
+void STRIPCHART_AddSample(STRIPCHART_Chart *chart, int16_t value) {
+    // Fold the sample into the min/max of the pending row
+    if (chart->count == 0 || value < chart->low) chart->low = value;
+    if (chart->count == 0 || value > chart->high) chart->high = value;
+    if (++chart->count < chart->samplesPerRow) {
+        return;
+    }
+    chart->count = 0;
+
+    int16_t low = STRIPCHART_ValueToColumn(chart, chart->low);
+    int16_t high = STRIPCHART_ValueToColumn(chart, chart->high);
+
+    // Join the trace to the previous point so steep slopes stay continuous
+    if (chart->lastColumn >= 0) {
+        if (chart->lastColumn < low) low = chart->lastColumn;
+        if (chart->lastColumn > high) high = chart->lastColumn;
+    }
+    chart->lastColumn = STRIPCHART_ValueToColumn(chart, value);
+
+    STRIPCHART_DrawRow(chart, low, high);
+}
+
+/*
+ * @brief Restores the whole frame memory as a non-scrolled area.
+ */
+void STRIPCHART_Release(void) {
+    ST77XX_SetScrollArea(0, ST77XX_MEMORY_ROWS);
+    ST77XX_SetScrollStart(0);
+}
@@ -0,0 +1,88 @@
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include <stdint.h>
+
+/*
+ * Declarations of functions for the hardware-scrolled strip chart.
+ *
+ * The chart lives in the ST77XX vertical scrolling area, so time runs along frame memory rows. Each plotted point is
+ * one row drawn as a single window; the hardware scroll start (VSCSAD) then moves the whole trace by one row, so
+ * nothing else is redrawn. Samples are queued in a ring buffer (safe to fill from an interrupt) and folded with
+ * min/max decimation when several samples share a row.
+ *
+ * Hardware scrolling always runs along frame memory rows, covering the full memory width. The chart follows the
+ * orientation set with ST77XX_SetOrientation: in landscape the memory rows are display columns, so time runs
+ * horizontally and the value axis is vertical. Set the orientation before STRIPCHART_Init.
+ */
+
+/*
+ * @brief Size of the sample ring buffer; must be a power of two.
+ */
+#ifndef STRIPCHART_RING_SIZE
+#define STRIPCHART_RING_SIZE 16
+#endif
+
+/*
+ * @brief State and configuration of a strip chart.
+ *
+ * The caller fills in the configuration fields, then calls STRIPCHART_Init.
+ */
+typedef struct {
+    uint16_t firstRow;         // First memory row of the scrolling area, counted from the top of the native view
+    uint16_t rows;             // Number of rows in the scrolling area, one per plotted point
+    int16_t valueStart;        // First coordinate of the value axis, across the memory rows
+    uint16_t valueLength;      // Number of pixels of the value axis
+    int16_t minValue;          // Sample value drawn at valueStart
+    int16_t maxValue;          // Sample value drawn at valueStart + valueLength - 1
+    uint8_t samplesPerRow;     // Samples folded into one row with min/max decimation
+    uint16_t traceColor;       // Color of the trace
+    uint16_t backgroundColor;  // Color of the chart background
+
+    uint16_t head;                       // Row index of the next point within the scrolling area
+    uint8_t count;                       // Samples accumulated for the next point
+    int16_t low;                         // Smallest sample accumulated for the next point
+    int16_t high;                        // Largest sample accumulated for the next point
+    int16_t lastColumn;                  // Value axis offset of the previous point, or -1 before the first one
+    int16_t ring[STRIPCHART_RING_SIZE];  // Queued samples
+    volatile uint8_t ringHead;           // Index where the next sample is queued
+    volatile uint8_t ringTail;           // Index of the oldest queued sample
+} STRIPCHART_Chart;
+
+/*
+ * @brief Clears the chart area and sets up the hardware scrolling area.
+ *
+ * @param chart The chart to initialize.
+ */
+void STRIPCHART_Init(STRIPCHART_Chart *chart);
+
+/*
+ * @brief Queues a sample; safe to call from an interrupt.
+ *
+ * @param chart The chart receiving the sample.
+ * @param value The sample value.
+ * @return 1 if the sample was queued, 0 if the ring buffer was full and the sample was dropped.
+ */
+uint8_t STRIPCHART_Push(STRIPCHART_Chart *chart, int16_t value);
+
+/*
+ * @brief Plots all queued samples.
+ *
+ * @param chart The chart to update.
+ */
+void STRIPCHART_Update(STRIPCHART_Chart *chart);
+
+/*
+ * @brief Adds a sample directly, bypassing the ring buffer.
+ *
+ * @param chart The chart receiving the sample.
+ * @param value The sample value.
+ */
+void STRIPCHART_AddSample(STRIPCHART_Chart *chart, int16_t value);
+
+/*
+ * @brief Restores the whole frame memory as a non-scrolled area.
+ */
+void STRIPCHART_Release(void);
+
+#endif  // STRIPCHART_H
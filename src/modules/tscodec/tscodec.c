@@ -0,0 +1,208 @@
+/*
+ * Include the header file for the compressed time-series codec.
+ */
+#include "tscodec.h"
+
+/*
+ * @brief Writes an unsigned varint.
+ *
+ * @param value The value.
+ * @param data Buffer receiving up to 5 bytes.
+ * @return The number of bytes written.
+ */
+static uint8_t TSCODEC_PutVarint(uint32_t value, uint8_t *data) {
+    uint8_t length = 0;
+    while (value >= 0x80) {
+        data[length++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    data[length++] = value;
+    return length;
+}
+
+/*
+ * @brief Reads an unsigned varint.
+ *
+ * @param data The block.
+ * @param position Offset of the varint in the block, advanced past it.
+ * @param length Number of bytes in the block.
+ * @param value Receives the value.
+ * @return 1 if a whole varint was read, 0 at the end of the block.
+ */
+static uint8_t TSCODEC_GetVarint(const uint8_t *data, uint8_t *position, uint8_t length, uint32_t *value) {
+    uint32_t result = 0;
+    for (uint8_t shift = 0; *position < length && shift < 35; shift += 7) {
+        uint8_t byte = data[(*position)++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * @brief Reads the timestamp of the full sample that starts a block.
+ *
+ * @param data The block.
+ * @return The timestamp.
+ */
+static uint32_t TSCODEC_Timestamp(const uint8_t *data) {
+    uint32_t timestamp = 0;
+    for (uint8_t i = 4; i-- > 0;) {
+        timestamp = (timestamp << 8) | data[i];
+    }
+    return timestamp;
+}
+
+/*
+ * @brief Decodes a block, passing the samples of a time range to a callback.
+ *
+ * @param data The block.
+ * @param length Number of bytes in the block.
+ * @param from The first timestamp of the range.
+ * @param to The last timestamp of the range.
+ * @param callback Function receiving each sample of the range.
+ * @return 1 once a sample past the range was reached, 0 otherwise.
+ */
+static uint8_t TSCODEC_Decode(const uint8_t *data, uint8_t length, uint32_t from, uint32_t to,
+                              TSCODEC_Callback callback) {
+    if (length < TSCODEC_HEADER) return 0;
+
+    uint32_t timestamp = TSCODEC_Timestamp(data);
+    int16_t value = data[4] | (uint16_t)data[5] << 8;
+
+    uint8_t position = TSCODEC_HEADER;
+    uint32_t timeDelta;
+    uint32_t valueDelta;
+    while (1) {
+        if (timestamp > to) return 1;
+        if (timestamp >= from) callback(timestamp, value);
+
+        if (!TSCODEC_GetVarint(data, &position, length, &timeDelta)) return 0;
+        if (!TSCODEC_GetVarint(data, &position, length, &valueDelta)) return 0;
+        timestamp += timeDelta;
+        value += (int32_t)(valueDelta >> 1) ^ -(int32_t)(valueDelta & 1);  // Undo the zigzag encoding
+    }
+}
+
+/*
+ * @brief Initializes an encoder writing to a mounted log.
+ *
+ * @param encoder The encoder to initialize.
+ * @param log The log receiving the blocks.
+ */
+void TSCODEC_Init(TSCODEC_Encoder *encoder, DATALOG_Log *log) {
+    encoder->log = log;
+    encoder->hasSample = 0;
+}
+
+/*
+ * @brief Commits the block being encoded, even if it is not full.
+ *
+ * @param encoder The encoder.
+ * @return TSCODEC_OK, or the error of the commit; the block stays in SRAM on error.
+ *
+ * The block is encoded in the log's own buffer, so retrying after an error
+ * commits it once and later samples keep extending it meanwhile.
+ */
+uint8_t TSCODEC_Flush(TSCODEC_Encoder *encoder) {
+    uint8_t status = DATALOG_Commit(encoder->log);
+    if (status == DATALOG_OK) encoder->hasSample = 0;
+    return status;
+}
+
+/*
+ * @brief Compresses a sample into the block being encoded, committing the block first if the sample does not fit.
+ *
+ * @param encoder The encoder.
+ * @param timestamp The timestamp of the sample, not older than the previous one.
+ * @param value The value of the sample.
+ * @return TSCODEC_OK, TSCODEC_ERROR_ORDER, or the error of the commit.
+ */
+uint8_t TSCODEC_Append(TSCODEC_Encoder *encoder, uint32_t timestamp, int16_t value) {
+    uint8_t pending;
+    DATALOG_GetPending(encoder->log, &pending);
+
+    if (encoder->hasSample && pending > 0) {
+        if (timestamp < encoder->timestamp) return TSCODEC_ERROR_ORDER;
+
+        uint8_t pair[10];
+        int32_t delta = (int32_t)value - encoder->value;
+        uint8_t size = TSCODEC_PutVarint(timestamp - encoder->timestamp, pair);
+        size += TSCODEC_PutVarint(((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31), pair + size);  // Zigzag
+
+        // Appended only where it fits, so DATALOG_Append never commits on its own
+        if (pending + size <= DATALOG_PAYLOAD) {
+            uint8_t status = DATALOG_Append(encoder->log, pair, size);
+            if (status != DATALOG_OK) return status;
+            encoder->timestamp = timestamp;
+            encoder->value = value;
+            return TSCODEC_OK;
+        }
+    }
+
+    // One block per commit, so every block starts with a full sample
+    if (pending > 0) {
+        uint8_t status = TSCODEC_Flush(encoder);
+        if (status != TSCODEC_OK) return status;
+    }
+
+    uint8_t header[TSCODEC_HEADER];
+    for (uint8_t i = 0; i < 4; i++) {
+        header[i] = timestamp >> (8 * i);
+    }
+    header[4] = (uint16_t)value & 0xFF;
+    header[5] = (uint16_t)value >> 8;
+    uint8_t status = DATALOG_Append(encoder->log, header, TSCODEC_HEADER);
+    if (status != DATALOG_OK) return status;
+
+    encoder->hasSample = 1;
+    encoder->timestamp = timestamp;
+    encoder->value = value;
+    return TSCODEC_OK;
+}
+
+/*
+ * @brief Decodes the samples of a time range, including those not yet committed.
+ *
+ * @param encoder The encoder.
+ * @param from The first timestamp of the range.
+ * @param to The last timestamp of the range.
+ * @param callback Function receiving each sample of the range, oldest first.
+ * @return TSCODEC_OK, or the I2C error of a block read; blocks failing their CRC are skipped.
+ */
+uint8_t TSCODEC_Read(TSCODEC_Encoder *encoder, uint32_t from, uint32_t to, TSCODEC_Callback callback) {
+    uint8_t data[DATALOG_PAYLOAD];
+    uint8_t length;
+    uint16_t count = DATALOG_GetBlockCount(encoder->log);
+
+    // Find the last block starting at or before the range; unreadable blocks send the search earlier
+    uint16_t low = 0;
+    uint16_t high = count;
+    while (high - low > 1) {
+        uint16_t middle = low + (high - low) / 2;
+        uint8_t status = DATALOG_ReadBlock(encoder->log, middle, data, &length);
+        if (status != DATALOG_OK && status != DATALOG_ERROR_CORRUPT) return status;
+
+        if (status == DATALOG_OK && length >= TSCODEC_HEADER && TSCODEC_Timestamp(data) <= from) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    for (uint16_t index = low; index < count; index++) {
+        uint8_t status = DATALOG_ReadBlock(encoder->log, index, data, &length);
+        if (status == DATALOG_ERROR_CORRUPT) continue;
+        if (status != DATALOG_OK) return status;
+        if (TSCODEC_Decode(data, length, from, to, callback)) return TSCODEC_OK;
+    }
+
+    if (encoder->hasSample) {
+        const uint8_t *pending = DATALOG_GetPending(encoder->log, &length);
+        TSCODEC_Decode(pending, length, from, to, callback);
+    }
+    return TSCODEC_OK;
+}
@@ -0,0 +1,103 @@
+/*
+ * Header guard to prevent multiple inclusions of the "tscodec.h" header file.
+ */
+#ifndef TSCODEC_H
+#define TSCODEC_H
+
+#include <stdint.h>
+
+#include "../datalog/datalog.h"
+
+/*
+ * Declarations of functions for the compressed time-series codec.
+ *
+ * Samples (a timestamp and a 16-bit value) are compressed into blocks that
+ * each fill one DATALOG block. A block starts with the first sample in full:
+ *
+ *     timestamp (4 bytes) | value (2 bytes)
+ *
+ * little-endian, followed by one pair per further sample: the timestamp delta
+ * as an unsigned varint, then the value delta zigzag-encoded as a varint.
+ * Varints hold 7 bits per byte, low bits first, with the top bit set on every
+ * byte but the last. A steady signal sampled at a fixed interval takes two
+ * bytes per sample instead of six.
+ *
+ * Blocks are encoded as samples arrive, each sample appended as one entry to
+ * the block the log is filling, and committed when the next sample would not
+ * fit. Since every block starts with a full sample,
+ * reads binary-search the blocks by their first timestamp and decode from
+ * there. Decoding costs a few shifts and adds per sample.
+ *
+ * The encoder must be the only writer of its log.
+ */
+
+/*
+ * Status codes besides DATALOG_OK, the DATALOG_ERROR_* and the I2C_ERROR_* codes.
+ */
+#define TSCODEC_OK 0              // Same value as DATALOG_OK
+#define TSCODEC_ERROR_ORDER 0x30  // Timestamp older than the previous sample
+
+/*
+ * @brief Bytes of the full sample that starts a block.
+ */
+#define TSCODEC_HEADER 6
+
+/*
+ * @brief State of an encoder.
+ */
+typedef struct {
+    DATALOG_Log *log;    // Log receiving the blocks
+    uint32_t timestamp;  // Timestamp of the last sample
+    int16_t value;       // Value of the last sample
+    uint8_t hasSample;   // 1 once timestamp and value hold a sample of the log's pending block
+} TSCODEC_Encoder;
+
+/*
+ * @brief Function receiving decoded samples.
+ *
+ * @param timestamp The timestamp of the sample.
+ * @param value The value of the sample.
+ */
+typedef void (*TSCODEC_Callback)(uint32_t timestamp, int16_t value);
+
+/*
+ * @brief Initializes an encoder writing to a mounted log.
+ *
+ * @param encoder The encoder to initialize.
+ * @param log The log receiving the blocks.
+ */
+void TSCODEC_Init(TSCODEC_Encoder *encoder, DATALOG_Log *log);
+
+/*
+ * @brief Compresses a sample into the block being encoded, committing the block first if the sample does not fit.
+ *
+ * @param encoder The encoder.
+ * @param timestamp The timestamp of the sample, not older than the previous one.
+ * @param value The value of the sample.
+ * @return TSCODEC_OK, TSCODEC_ERROR_ORDER, or the error of the commit.
+ */
+uint8_t TSCODEC_Append(TSCODEC_Encoder *encoder, uint32_t timestamp, int16_t value);
+
+/*
+ * @brief Commits the block being encoded, even if it is not full.
+ *
+ * @param encoder The encoder.
+ * @return TSCODEC_OK, or the error of the commit; the block stays in SRAM on error.
+ *
+ * The block is encoded in the log's own buffer, so retrying after an error
+ * commits it once and later samples keep extending it meanwhile.
+ */
+uint8_t TSCODEC_Flush(TSCODEC_Encoder *encoder);
+
+/*
+ * @brief Decodes the samples of a time range, including those not yet committed.
+ *
+ * @param encoder The encoder.
+ * @param from The first timestamp of the range.
+ * @param to The last timestamp of the range.
+ * @param callback Function receiving each sample of the range, oldest first.
+ * @return TSCODEC_OK, or the I2C error of a block read; blocks failing their CRC are skipped.
+ */
+uint8_t TSCODEC_Read(TSCODEC_Encoder *encoder, uint32_t from, uint32_t to, TSCODEC_Callback callback);
+
+#endif  // TSCODEC_H
@@ -1,33 +1,67 @@
 #include "i2c.h"
 
+#include <avr/interrupt.h>
 #include <compat/twi.h>
 #include <util/delay.h>
 
+/*
+ * Interrupt enable bit written with every TWCR command: TWIE while the queue
+ * runs from TWI_vect, 0 while I2C_Transfer polls the state machine itself.
+ */
+static uint8_t I2C_interruptEnable = (1 << TWIE);
+
+/**
+ * @brief Waits for TWINT, giving up after I2C_TIMEOUT_US.
+ *
+ * @return 1 if TWINT was set in time, 0 on timeout.
+ */
+static uint8_t I2C_WaitForInterrupt() {
+    for (uint16_t i = 0; i < I2C_TIMEOUT_US; i++) {
+        if (TWCR & (1 << TWINT)) return 1;
+        _delay_us(1);
+    }
+    return (TWCR & (1 << TWINT)) != 0;
+}
+
+/**
+ * @brief Waits for a STOP condition to be executed, giving up after I2C_TIMEOUT_US.
+ *
+ * @return 1 if the STOP condition was sent in time, 0 on timeout.
+ */
+static uint8_t I2C_WaitForStop() {
+    for (uint16_t i = 0; i < I2C_TIMEOUT_US; i++) {
+        if (!(TWCR & (1 << TWSTO))) return 1;
+        _delay_us(1);
+    }
+    return !(TWCR & (1 << TWSTO));
+}
+
+/*
+ * Frequency requested by the last I2C_SetFrequency call, in Hz.
+ */
+static uint32_t I2C_frequency = 0;
+
 /**
  * @brief Initializes the I2C (TWI) interface.
  *
- * This function sets up the I2C interface with a clock frequency
- * determined by the prescaler value passed.
+ * This function sets up the I2C interface with one of four clock frequencies
+ * and enables the TWI module. TWBR and TWPS are chosen by I2C_SetFrequency.
  *
- * @param prescaler The desired prescaler value (0 for 1, 1 for 4, 2 for 16, 3 for 64).
+ * @param prescaler Selects the clock frequency (0 for 100kHz, 1 for 400kHz, 2 for 50kHz, 3 for 25kHz).
  */
 void I2C_Init(uint8_t prescaler) {
-    // Set the prescaler bits in TWSR
-    TWSR = (prescaler & 0x03);  // Mask to ensure only the lower 2 bits are used
-
-    // Calculate and set the TWBR value for the corresponding frequency
     uint32_t frequency;
     switch (prescaler) {
-        case 0:                    // Prescaler = 1
+        case 0:
             frequency = 100000UL;  // 100kHz
             break;
-        case 1:                    // Prescaler = 4
+        case 1:
             frequency = 400000UL;  // 400kHz
             break;
-        case 2:                   // Prescaler = 16
+        case 2:
             frequency = 50000UL;  // 50kHz
             break;
-        case 3:                   // Prescaler = 64
+        case 3:
             frequency = 25000UL;  // 25kHz
             break;
         default:
@@ -35,13 +69,64 @@ void I2C_Init(uint8_t prescaler) {
             break;
     }
 
-    // Calculate the TWBR value for the desired frequency
-    TWBR = ((F_CPU / frequency) - 16) / 2;
+    I2C_SetFrequency(frequency);
 
     // Enable TWI
     TWCR = (1 << TWEN);
 }
 
+/**
+ * @brief Computes the TWBR and TWPS values for an SCL frequency.
+ *
+ * SCL runs at F_CPU / (16 + 2 * TWBR * 4^TWPS). The smallest prescaler that
+ * reaches the frequency is used, and TWBR is rounded up so the bus never runs
+ * faster than requested.
+ *
+ * @param frequency The requested SCL frequency in Hz; 0 selects the slowest rate.
+ * @param bitRate Receives the TWBR value.
+ * @param prescaler Receives the TWPS value (0 for 1, 1 for 4, 2 for 16, 3 for 64).
+ *
+ * @return The SCL frequency achieved with these values, in Hz.
+ */
+uint32_t I2C_ComputeBitRate(uint32_t frequency, uint8_t *bitRate, uint8_t *prescaler) {
+    if (frequency == 0) frequency = 1;  // Clamped to the slowest rate below
+    uint32_t cycles = (F_CPU + frequency - 1) / frequency;  // SCL period in CPU cycles, rounded up
+    uint32_t steps = cycles > 16 ? (cycles - 16 + 1) / 2 : 0;
+
+    // Pick the smallest prescaler whose TWBR fits in 8 bits
+    uint8_t twps = 0;
+    while (twps < 3 && (steps + (1UL << (2 * twps)) - 1) >> (2 * twps) > 255) {
+        twps++;
+    }
+    uint32_t twbr = (steps + (1UL << (2 * twps)) - 1) >> (2 * twps);
+    if (twbr > 255) twbr = 255;  // Slowest rate reachable
+
+    *bitRate = twbr;
+    *prescaler = twps;
+    return F_CPU / (16 + 2 * (twbr << (2 * twps)));
+}
+
+/**
+ * @brief Sets the SCL frequency of the I2C bus.
+ *
+ * @param frequency The requested SCL frequency in Hz, or 0 to keep the current one as for transactions.
+ *
+ * @return The SCL frequency achieved in Hz, never above the requested one unless that is below the slowest rate.
+ *
+ * Transactions with a frequency of their own change it again before they start.
+ */
+uint32_t I2C_SetFrequency(uint32_t frequency) {
+    if (frequency == 0) frequency = I2C_frequency ? I2C_frequency : 100000UL;  // Before I2C_Init, the default speed
+
+    uint8_t bitRate;
+    uint8_t prescaler;
+    uint32_t achieved = I2C_ComputeBitRate(frequency, &bitRate, &prescaler);
+    TWBR = bitRate;
+    TWSR = prescaler;  // The status bits of TWSR are read-only
+    I2C_frequency = frequency;
+    return achieved;
+}
+
 /**
  * @brief Sends a START condition on the I2C bus.
  *
@@ -49,9 +134,8 @@ void I2C_Init(uint8_t prescaler) {
  */
 void I2C_Start() {
     TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);  // Send START condition
-    while (!(TWCR & (1 << TWINT)))
-        ;  // Wait for TWINT Flag set. This indicates that the START condition has
-           // been transmitted.
+    I2C_WaitForInterrupt();  // Wait for TWINT Flag set. This indicates that the START condition has
+                             // been transmitted.
 }
 
 /**
@@ -61,8 +145,7 @@ void I2C_Start() {
  */
 void I2C_Stop() {
     TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);  // Send STOP condition
-    while (TWCR & (1 << TWSTO))
-        ;  // Wait for STOP condition to be executed and bus released
+    I2C_WaitForStop();  // Wait for STOP condition to be executed and bus released
 }
 
 /**
@@ -76,9 +159,8 @@ void I2C_Stop() {
 void I2C_Write(uint8_t data) {
     TWDR = data;                        // Load data into TWDR register
     TWCR = (1 << TWINT) | (1 << TWEN);  // Start transmission
-    while (!(TWCR & (1 << TWINT)))
-        ;  // Wait for TWINT Flag set. This indicates that the data has been
-           // transmitted, and ACK/NACK has been received.
+    I2C_WaitForInterrupt();  // Wait for TWINT Flag set. This indicates that the data has been
+                             // transmitted, and ACK/NACK has been received.
 }
 
 /**
@@ -91,10 +173,9 @@ void I2C_Write(uint8_t data) {
  */
 uint8_t I2C_ReadAck() {
     TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);  // Enable TWI and acknowledge bit
-    while (!(TWCR & (1 << TWINT)))
-        ;         // Wait for TWINT Flag set. This indicates that the data has been
-                  // received.
-    return TWDR;  // Return received data
+    I2C_WaitForInterrupt();  // Wait for TWINT Flag set. This indicates that the data has been
+                             // received.
+    return TWDR;             // Return received data
 }
 
 /**
@@ -107,8 +188,484 @@ uint8_t I2C_ReadAck() {
  */
 uint8_t I2C_ReadNack() {
     TWCR = (1 << TWINT) | (1 << TWEN);  // Enable TWI without acknowledge bit
-    while (!(TWCR & (1 << TWINT)))
-        ;         // Wait for TWINT Flag set. This indicates that the data has been
-                  // received.
-    return TWDR;  // Return received data
+    I2C_WaitForInterrupt();  // Wait for TWINT Flag set. This indicates that the data has been
+                             // received.
+    return TWDR;             // Return received data
+}
+
+/*
+ * Queue of the interrupt-driven engine; the head is the transaction on the bus.
+ */
+static I2C_Transaction *volatile I2C_queueHead = NULL;
+static I2C_Transaction *I2C_queueTail = NULL;
+
+/*
+ * TWEA and TWIE while the slave engine answers its address, 0 otherwise; kept
+ * in every TWCR command that leaves the bus idle.
+ */
+static uint8_t I2C_slaveEnable = 0;
+
+/*
+ * State of the slave engine.
+ */
+static volatile uint8_t *I2C_slaveRegisters;           // Register file in SRAM
+static uint8_t I2C_slaveSize;                          // Number of registers
+static uint8_t I2C_slavePointer;                       // Register accessed by the next data byte
+static uint8_t I2C_slaveStart;                         // First register written in the current transaction
+static uint8_t I2C_slaveCount;                         // Registers written so far, 0xFF before the pointer byte
+static I2C_SlaveWriteCallback I2C_slaveWriteCallback;  // Called after the host wrote registers
+static I2C_SlaveReadCallback I2C_slaveReadCallback;    // Called before the host reads registers
+
+/*
+ * Position within the prefix and write buffer, or within the read buffer after the repeated START;
+ * I2C_Transfer watches it for progress of the queue.
+ */
+static volatile uint16_t I2C_index;
+
+/*
+ * Number of bytes in readData not yet handed to the chunk callback.
+ */
+static uint16_t I2C_chunkIndex;
+
+/**
+ * @brief Sends a START condition and lets the interrupt take over.
+ *
+ * Only TWEA is taken from I2C_slaveEnable, so a polled I2C_Transfer does not
+ * have TWI_vect race its loop for the bus events of the START.
+ */
+static inline void I2C_StartAsync() {
+    TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | I2C_interruptEnable | (I2C_slaveEnable & (1 << TWEA));
+}
+
+/**
+ * @brief Tells whether a transaction needs the bus speed changed before it starts.
+ *
+ * @param transaction The transaction about to start.
+ *
+ * @return 1 if its frequency differs from the current one, 0 otherwise.
+ */
+static inline uint8_t I2C_NeedsFrequency(I2C_Transaction *transaction) {
+    return transaction->frequency && transaction->frequency != I2C_frequency;
+}
+
+/**
+ * @brief Starts the transaction at the head of the queue once the bus is free.
+ *
+ * Waits for a pending STOP condition and switches to the transaction's bus
+ * speed before sending the START condition.
+ */
+static void I2C_StartNext() {
+    I2C_WaitForStop();
+    if (I2C_NeedsFrequency(I2C_queueHead)) I2C_SetFrequency(I2C_queueHead->frequency);
+    I2C_StartAsync();
+}
+
+/**
+ * @brief Acknowledges the current state and lets the interrupt handle the next one.
+ *
+ * @param ack 1 to acknowledge the next received byte, 0 to answer it with NACK.
+ */
+static inline void I2C_ContinueAsync(uint8_t ack) {
+    TWCR = (1 << TWINT) | (1 << TWEN) | I2C_interruptEnable | (ack ? (1 << TWEA) : 0);
+}
+
+/**
+ * @brief Stores a received byte, handing readData to the chunk callback when it is full.
+ *
+ * @param transaction The transaction being read.
+ *
+ * The bus is stretched while the callback runs, since TWINT stays set.
+ */
+static void I2C_Receive(I2C_Transaction *transaction) {
+    transaction->readData[I2C_chunkIndex++] = TWDR;
+    I2C_index++;
+    if (transaction->chunkCallback &&
+        (I2C_chunkIndex == transaction->chunkSize || I2C_index == transaction->readLength)) {
+        transaction->chunkCallback(transaction->readData, I2C_chunkIndex);
+        I2C_chunkIndex = 0;
+    }
+}
+
+/**
+ * @brief Checks that a transaction can run without overrunning its buffers.
+ *
+ * @param transaction The transaction about to be queued.
+ *
+ * @return 0 if it has a chunk callback but a chunkSize of 0, 1 otherwise.
+ */
+static inline uint8_t I2C_IsValid(I2C_Transaction *transaction) {
+    return !transaction->chunkCallback || transaction->chunkSize;
+}
+
+/**
+ * @brief Completes the transaction on the bus and starts the next queued one.
+ *
+ * @param status The status to report for the completed transaction.
+ */
+static void I2C_Finish(uint8_t status) {
+    I2C_Transaction *transaction = I2C_queueHead;
+    I2C_queueHead = transaction->next;
+
+    if (status == I2C_ERROR_ARBITRATION) {
+        // The other master owns the bus, so leave without a STOP
+        TWCR = (1 << TWINT) | (1 << TWEN) | I2C_slaveEnable;
+        if (I2C_queueHead && I2C_interruptEnable) I2C_StartNext();  // Restarts once the bus is free
+    } else if (I2C_queueHead && I2C_interruptEnable && !I2C_NeedsFrequency(I2C_queueHead)) {
+        // STOP followed by START for the next transaction
+        TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWSTA) | (1 << TWEN) | I2C_interruptEnable | I2C_slaveEnable;
+    } else if (I2C_queueHead && I2C_interruptEnable) {
+        // Finish the STOP at the current speed before switching to the next device's
+        TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+        I2C_StartNext();
+    } else {
+        TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN) | I2C_slaveEnable;
+    }
+
+    transaction->status = status;
+    if (transaction->callback) transaction->callback(transaction);
+}
+
+/**
+ * @brief Queues a transaction for the interrupt-driven engine.
+ *
+ * @param transaction The transaction to run; its status becomes I2C_PENDING, or I2C_ERROR_INVALID at once
+ *        when it has a chunk callback and a chunkSize of 0.
+ *
+ * The transaction starts at once if the bus is idle, otherwise after the ones
+ * queued before it. Interrupts must be enabled for the queue to progress, and
+ * the blocking functions above must not be used while it is busy.
+ */
+void I2C_Submit(I2C_Transaction *transaction) {
+    if (!I2C_IsValid(transaction)) {
+        transaction->status = I2C_ERROR_INVALID;
+        if (transaction->callback) transaction->callback(transaction);
+        return;
+    }
+
+    transaction->status = I2C_PENDING;
+    transaction->next = NULL;
+
+    uint8_t sreg = SREG;
+    cli();
+    if (I2C_queueHead) {
+        I2C_queueTail->next = transaction;
+        I2C_queueTail = transaction;
+    } else {
+        I2C_queueHead = transaction;
+        I2C_queueTail = transaction;
+        I2C_StartNext();
+    }
+    SREG = sreg;
+}
+
+/**
+ * @brief Tells whether the interrupt-driven engine still has transactions to run.
+ *
+ * @return 1 while a transaction is queued or in progress, 0 when the engine is idle.
+ */
+uint8_t I2C_IsBusy() { return I2C_queueHead != NULL; }
+
+/**
+ * @brief Answers the bus event of a host addressing the slave engine.
+ *
+ * The first byte the host writes selects a register, the following ones are
+ * stored from there on. Reads return registers from the selected one on. The
+ * register pointer wraps at the end of the register file.
+ */
+static void I2C_SlaveService() {
+    switch (TW_STATUS) {
+        case TW_SR_SLA_ACK:
+        case TW_SR_ARB_LOST_SLA_ACK:
+        case TW_SR_GCALL_ACK:
+        case TW_SR_ARB_LOST_GCALL_ACK:
+            I2C_slaveCount = 0xFF;  // Expect the register pointer first
+            break;
+
+        case TW_SR_DATA_ACK:
+        case TW_SR_GCALL_DATA_ACK:
+            if (I2C_slaveCount == 0xFF) {
+                I2C_slavePointer = TWDR < I2C_slaveSize ? TWDR : 0;
+                I2C_slaveStart = I2C_slavePointer;
+                I2C_slaveCount = 0;
+            } else {
+                I2C_slaveRegisters[I2C_slavePointer] = TWDR;
+                if (++I2C_slavePointer == I2C_slaveSize) I2C_slavePointer = 0;
+                if (I2C_slaveCount < I2C_slaveSize) I2C_slaveCount++;
+            }
+            break;
+
+        case TW_SR_STOP:
+            // STOP or repeated START ends the write
+            if (I2C_slaveCount != 0xFF && I2C_slaveCount > 0 && I2C_slaveWriteCallback) {
+                I2C_slaveWriteCallback(I2C_slaveStart, I2C_slaveCount);
+            }
+            I2C_slaveCount = 0;
+            break;
+
+        case TW_ST_SLA_ACK:
+        case TW_ST_ARB_LOST_SLA_ACK:
+            if (I2C_slaveReadCallback) I2C_slaveReadCallback(I2C_slavePointer);
+            // Fall through - load the first byte
+        case TW_ST_DATA_ACK:
+            TWDR = I2C_slaveRegisters[I2C_slavePointer];
+            if (++I2C_slavePointer == I2C_slaveSize) I2C_slavePointer = 0;
+            break;
+
+        default:
+            // TW_SR_DATA_NACK, TW_ST_DATA_NACK, TW_ST_LAST_DATA: the transaction is over
+            break;
+    }
+
+    // Keep answering the address, and retry a START deferred by the host's transaction
+    TWCR = (1 << TWINT) | (1 << TWEN) | I2C_interruptEnable | (1 << TWEA) | (I2C_queueHead ? (1 << TWSTA) : 0);
+}
+
+/**
+ * @brief Advances the transaction at the head of the queue by one bus event.
+ */
+static void I2C_Service() {
+    if (TW_STATUS >= TW_SR_SLA_ACK && TW_STATUS <= TW_ST_LAST_DATA) {
+        I2C_SlaveService();
+        return;
+    }
+
+    I2C_Transaction *transaction = I2C_queueHead;
+    if (!transaction) {
+        TWCR = (1 << TWINT) | (1 << TWEN) | I2C_slaveEnable;  // Nothing queued, release the interrupt
+        return;
+    }
+
+    uint16_t writeEnd = transaction->prefixLength + transaction->writeLength;
+
+    switch (TW_STATUS) {
+        case TW_START:
+            I2C_index = 0;
+            if (writeEnd > 0 || transaction->readLength == 0) {
+                TWDR = (transaction->address << 1) | TW_WRITE;
+            } else {
+                TWDR = (transaction->address << 1) | TW_READ;
+            }
+            I2C_ContinueAsync(0);
+            break;
+
+        case TW_REP_START:
+            TWDR = (transaction->address << 1) | TW_READ;
+            I2C_ContinueAsync(0);
+            break;
+
+        case TW_MT_SLA_ACK:
+        case TW_MT_DATA_ACK:
+            if (I2C_index < transaction->prefixLength) {
+                TWDR = transaction->prefix[I2C_index++];
+                I2C_ContinueAsync(0);
+            } else if (I2C_index < writeEnd) {
+                TWDR = transaction->writeData[I2C_index++ - transaction->prefixLength];
+                I2C_ContinueAsync(0);
+            } else if (transaction->readLength > 0) {
+                I2C_StartAsync();  // Repeated START for the read
+            } else {
+                I2C_Finish(I2C_OK);
+            }
+            break;
+
+        case TW_MR_SLA_ACK:
+            I2C_index = 0;
+            I2C_chunkIndex = 0;
+            I2C_ContinueAsync(transaction->readLength > 1);
+            break;
+
+        case TW_MR_DATA_ACK:
+            I2C_Receive(transaction);
+            I2C_ContinueAsync(transaction->readLength - I2C_index > 1);
+            break;
+
+        case TW_MR_DATA_NACK:
+            I2C_Receive(transaction);
+            I2C_Finish(I2C_OK);
+            break;
+
+        case TW_MT_SLA_NACK:
+        case TW_MR_SLA_NACK:
+            I2C_Finish(I2C_ERROR_ADDRESS_NACK);
+            break;
+
+        case TW_MT_DATA_NACK:
+            I2C_Finish(I2C_ERROR_DATA_NACK);
+            break;
+
+        case TW_MT_ARB_LOST:
+            I2C_Finish(I2C_ERROR_ARBITRATION);
+            break;
+
+        default:
+            I2C_Finish(I2C_ERROR_BUS);
+            break;
+    }
+}
+
+/**
+ * @brief Advances the queued transactions from the TWI interrupt.
+ */
+ISR(TWI_vect) { I2C_Service(); }
+
+/**
+ * @brief Runs a transaction to completion without interrupts.
+ *
+ * @param transaction The transaction to run; its callback is called as for queued transactions.
+ *
+ * @return I2C_OK, I2C_ERROR_INVALID if it has a chunk callback and a chunkSize of 0, or the error that ended
+ *         the transaction.
+ *
+ * Every bus event is awaited for at most I2C_TIMEOUT_US. On a timeout the bus
+ * is recovered with I2C_RecoverBus before returning I2C_ERROR_TIMEOUT, so a
+ * stuck device cannot hang the caller. Queued transactions run first; if
+ * they make no progress for I2C_TIMEOUT_US, I2C_ERROR_TIMEOUT is returned
+ * without touching the bus.
+ */
+uint8_t I2C_Transfer(I2C_Transaction *transaction) {
+    if (!I2C_IsValid(transaction)) {
+        transaction->status = I2C_ERROR_INVALID;
+        if (transaction->callback) transaction->callback(transaction);
+        return I2C_ERROR_INVALID;
+    }
+
+    uint8_t sreg;
+    for (;;) {
+        // Let queued transactions drain first; the bound restarts on every bus
+        // event, so it scales with the queued work and only a stalled queue fails
+        I2C_Transaction *head = I2C_queueHead;
+        uint16_t index = I2C_index;
+        for (uint16_t i = 0; I2C_IsBusy(); i++) {
+            if (I2C_queueHead != head || I2C_index != index) {
+                head = I2C_queueHead;
+                index = I2C_index;
+                i = 0;
+            }
+            if (i == I2C_TIMEOUT_US) {
+                transaction->status = I2C_ERROR_TIMEOUT;
+                if (transaction->callback) transaction->callback(transaction);
+                return I2C_ERROR_TIMEOUT;
+            }
+            _delay_us(1);
+        }
+
+        // Claim the queue only if no interrupt submitted a transaction since the check
+        sreg = SREG;
+        cli();
+        if (!I2C_queueHead) break;
+        SREG = sreg;
+    }
+
+    I2C_interruptEnable = 0;
+    transaction->status = I2C_PENDING;
+    transaction->next = NULL;
+    I2C_queueHead = transaction;
+    I2C_queueTail = transaction;
+    SREG = sreg;
+
+    // Drive the state machine from here instead of TWI_vect
+    uint8_t status = I2C_WaitForStop() ? I2C_PENDING : I2C_ERROR_TIMEOUT;
+    if (status == I2C_PENDING) I2C_StartNext();
+    while (status == I2C_PENDING) {
+        if (!I2C_WaitForInterrupt()) {
+            status = I2C_ERROR_TIMEOUT;
+            break;
+        }
+        I2C_Service();
+        status = transaction->status;
+    }
+
+    sreg = SREG;
+    cli();
+    if (status == I2C_ERROR_TIMEOUT) {
+        // The state machine never finished; drop the transaction and free the bus
+        I2C_queueHead = transaction->next;
+        I2C_RecoverBus();
+        transaction->status = I2C_ERROR_TIMEOUT;
+    }
+    I2C_interruptEnable = (1 << TWIE);
+    if (I2C_queueHead) {
+        I2C_StartNext();  // Transactions submitted from interrupts meanwhile
+    }
+    SREG = sreg;
+
+    if (status == I2C_ERROR_TIMEOUT && transaction->callback) transaction->callback(transaction);
+    return status;
+}
+
+/**
+ * @brief Frees a bus held low by a device stuck in the middle of a byte.
+ *
+ * Clocks SCL by hand until the device releases SDA, up to nine times, then
+ * sends a STOP condition and re-enables the TWI module. An enabled slave
+ * engine keeps answering its address afterwards.
+ *
+ * @return 1 if SDA is released, 0 if the bus is still held low.
+ */
+uint8_t I2C_RecoverBus() {
+    // Take the pins from the TWI module; lines are driven low through DDR only
+    TWCR = 0;
+    PORT_I2C &= ~((1 << DD_SCL) | (1 << DD_SDA));
+    DDR_I2C &= ~((1 << DD_SCL) | (1 << DD_SDA));
+
+    // Clock out the byte the device is still sending
+    for (uint8_t i = 0; i < 9 && !(PIN_I2C & (1 << DD_SDA)); i++) {
+        DDR_I2C |= (1 << DD_SCL);
+        _delay_us(5);
+        DDR_I2C &= ~(1 << DD_SCL);
+        _delay_us(5);
+    }
+
+    // STOP condition: SDA rises while SCL is high
+    DDR_I2C |= (1 << DD_SDA);
+    _delay_us(5);
+    DDR_I2C &= ~(1 << DD_SDA);
+    _delay_us(5);
+
+    uint8_t released = (PIN_I2C & (1 << DD_SDA)) != 0;
+    TWCR = (1 << TWEN) | I2C_slaveEnable;
+    return released;
+}
+
+/**
+ * @brief Makes the device answer as an I2C slave with a register file.
+ *
+ * @param address The 7-bit address to answer.
+ * @param registers The register file, in SRAM; it must stay valid while the slave is enabled.
+ * @param size Number of registers, 1 to 255.
+ * @param writeCallback Called after the host wrote registers, or NULL.
+ * @param readCallback Called before the host reads registers, or NULL.
+ *
+ * The host writes a register number followed by data to store from there on,
+ * and reads from the last register number written, with the pointer
+ * auto-incrementing in both directions. Everything runs in TWI_vect, so
+ * interrupts must be enabled; the master functions remain usable.
+ */
+void I2C_InitSlave(uint8_t address, volatile uint8_t *registers, uint8_t size, I2C_SlaveWriteCallback writeCallback,
+                   I2C_SlaveReadCallback readCallback) {
+    uint8_t sreg = SREG;
+    cli();
+    I2C_slaveRegisters = registers;
+    I2C_slaveSize = size;
+    I2C_slavePointer = 0;
+    I2C_slaveCount = 0;
+    I2C_slaveWriteCallback = writeCallback;
+    I2C_slaveReadCallback = readCallback;
+    I2C_slaveEnable = (1 << TWEA) | (1 << TWIE);
+
+    TWAR = address << 1;  // General call stays disabled
+    if (!I2C_queueHead) TWCR = (1 << TWEN) | I2C_slaveEnable;
+    SREG = sreg;
+}
+
+/**
+ * @brief Stops answering the slave address.
+ */
+void I2C_StopSlave() {
+    uint8_t sreg = SREG;
+    cli();
+    I2C_slaveEnable = 0;
+    TWAR = 0;
+    if (!I2C_queueHead) TWCR = (1 << TWEN);
+    SREG = sreg;
 }
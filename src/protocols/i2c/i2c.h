@@ -2,17 +2,138 @@
 #define I2C_H
 
 #include <avr/io.h>
+#include <stddef.h>
+
+/*
+ * @brief DDR register of the I2C pins.
+ *
+ * Used to drive SCL by hand when recovering a stuck bus.
+ */
+#define DDR_I2C DDRC
+
+/*
+ * @brief PORT register of the I2C pins.
+ */
+#define PORT_I2C PORTC
+
+/*
+ * @brief PIN register of the I2C pins.
+ */
+#define PIN_I2C PINC
+
+/*
+ * @brief SCL pin of the I2C bus.
+ */
+#define DD_SCL PC0
+
+/*
+ * @brief SDA pin of the I2C bus.
+ */
+#define DD_SDA PC1
+
+/*
+ * @brief Longest wait for a single bus event, in microseconds.
+ *
+ * A byte takes 90 us at 100 kHz, so this leaves room for clock stretching
+ * while bounding how long a dead bus can stall the caller.
+ */
+#define I2C_TIMEOUT_US 1000
+
+/*
+ * Completion status of an I2C transaction.
+ */
+#define I2C_OK 0                  // Transaction completed
+#define I2C_PENDING 1             // Queued or in progress
+#define I2C_ERROR_ADDRESS_NACK 2  // No device acknowledged the address
+#define I2C_ERROR_DATA_NACK 3     // The device refused a written byte
+#define I2C_ERROR_ARBITRATION 4   // Another master took the bus
+#define I2C_ERROR_BUS 5           // Illegal START or STOP seen on the bus
+#define I2C_ERROR_TIMEOUT 6       // A bus event did not complete within I2C_TIMEOUT_US
+#define I2C_ERROR_INVALID 7       // The transaction has a chunk callback but no chunkSize
+
+typedef struct I2C_Transaction I2C_Transaction;
+
+/**
+ * @brief Function called when a queued transaction completes.
+ *
+ * @param transaction The transaction that completed; its status tells whether it succeeded.
+ *
+ * Callbacks run inside the TWI interrupt, so they must be short. They may submit
+ * further transactions, including the one they received.
+ */
+typedef void (*I2C_Callback)(I2C_Transaction *transaction);
+
+/**
+ * @brief Function receiving the bytes of a read in chunks.
+ *
+ * @param data The bytes received, in the transaction's readData buffer.
+ * @param length Number of bytes in data.
+ *
+ * Runs inside the TWI interrupt for queued transactions, with SCL held low
+ * until it returns.
+ */
+typedef void (*I2C_ChunkCallback)(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief An I2C transaction: an optional write followed by an optional read after a repeated START.
+ *
+ * The prefix is sent before the write buffer so a register or memory address
+ * does not have to be copied in front of the payload. With a chunk callback,
+ * readData only needs chunkSize bytes however long the read is. Buffers must
+ * stay valid until the transaction completes.
+ */
+struct I2C_Transaction {
+    uint8_t address;                  // 7-bit device address
+    uint32_t frequency;               // SCL frequency for this device in Hz, or 0 to keep the current one
+    uint8_t prefix[2];                // Register or memory address sent first
+    uint8_t prefixLength;             // Number of prefix bytes to send (0 to 2)
+    const uint8_t *writeData;         // Bytes sent after the prefix
+    uint16_t writeLength;             // Number of bytes in writeData
+    uint8_t *readData;                // Buffer filled after the repeated START
+    uint16_t readLength;              // Number of bytes to read, 0 for a write-only transaction
+    I2C_ChunkCallback chunkCallback;  // Receives readData each time it holds chunkSize bytes, or NULL
+    uint16_t chunkSize;               // Size of readData when chunkCallback is set, at least 1
+    I2C_Callback callback;            // Called on completion, or NULL to poll status
+    volatile uint8_t status;          // I2C_PENDING until completion, then I2C_OK or an error
+    I2C_Transaction *next;            // Queue link, managed by the driver
+};
 
 /**
  * @brief Initializes the I2C (TWI) interface.
  *
- * This function sets up the I2C interface with a clock frequency
- * determined by the prescaler value passed.
+ * This function sets up the I2C interface with one of four clock frequencies
+ * and enables the TWI module. TWBR and TWPS are chosen by I2C_SetFrequency.
  *
- * @param prescaler The desired prescaler value (0 for 1, 1 for 4, 2 for 16, 3 for 64).
+ * @param prescaler Selects the clock frequency (0 for 100kHz, 1 for 400kHz, 2 for 50kHz, 3 for 25kHz).
  */
 void I2C_Init(uint8_t prescaler);
 
+/**
+ * @brief Computes the TWBR and TWPS values for an SCL frequency.
+ *
+ * SCL runs at F_CPU / (16 + 2 * TWBR * 4^TWPS). The smallest prescaler that
+ * reaches the frequency is used, and TWBR is rounded up so the bus never runs
+ * faster than requested.
+ *
+ * @param frequency The requested SCL frequency in Hz; 0 selects the slowest rate.
+ * @param bitRate Receives the TWBR value.
+ * @param prescaler Receives the TWPS value (0 for 1, 1 for 4, 2 for 16, 3 for 64).
+ *
+ * @return The SCL frequency achieved with these values, in Hz.
+ */
+uint32_t I2C_ComputeBitRate(uint32_t frequency, uint8_t *bitRate, uint8_t *prescaler);
+
+/**
+ * @brief Sets the SCL frequency of the I2C bus.
+ *
+ * @param frequency The requested SCL frequency in Hz, or 0 to keep the current one as for transactions.
+ *
+ * @return The SCL frequency achieved in Hz, never above the requested one unless that is below the slowest rate.
+ *
+ * Transactions with a frequency of their own change it again before they start.
+ */
+uint32_t I2C_SetFrequency(uint32_t frequency);
+
 /**
  * @brief Sends a START condition on the I2C bus.
  *
@@ -57,4 +178,92 @@ uint8_t I2C_ReadAck();
  */
 uint8_t I2C_ReadNack();
 
+/**
+ * @brief Runs a transaction to completion without interrupts.
+ *
+ * @param transaction The transaction to run; its callback is called as for queued transactions.
+ *
+ * @return I2C_OK, I2C_ERROR_INVALID if it has a chunk callback and a chunkSize of 0, or the error that ended
+ *         the transaction.
+ *
+ * Every bus event is awaited for at most I2C_TIMEOUT_US. On a timeout the bus
+ * is recovered with I2C_RecoverBus before returning I2C_ERROR_TIMEOUT, so a
+ * stuck device cannot hang the caller. Queued transactions run first; if
+ * they make no progress for I2C_TIMEOUT_US, I2C_ERROR_TIMEOUT is returned
+ * without touching the bus.
+ */
+uint8_t I2C_Transfer(I2C_Transaction *transaction);
+
+/**
+ * @brief Frees a bus held low by a device stuck in the middle of a byte.
+ *
+ * Clocks SCL by hand until the device releases SDA, up to nine times, then
+ * sends a STOP condition and re-enables the TWI module. An enabled slave
+ * engine keeps answering its address afterwards.
+ *
+ * @return 1 if SDA is released, 0 if the bus is still held low.
+ */
+uint8_t I2C_RecoverBus();
+
+/**
+ * @brief Queues a transaction for the interrupt-driven engine.
+ *
+ * @param transaction The transaction to run; its status becomes I2C_PENDING, or I2C_ERROR_INVALID at once
+ *        when it has a chunk callback and a chunkSize of 0.
+ *
+ * The transaction starts at once if the bus is idle, otherwise after the ones
+ * queued before it. Interrupts must be enabled for the queue to progress, and
+ * the blocking functions above must not be used while it is busy.
+ */
+void I2C_Submit(I2C_Transaction *transaction);
+
+/**
+ * @brief Tells whether the interrupt-driven engine still has transactions to run.
+ *
+ * @return 1 while a transaction is queued or in progress, 0 when the engine is idle.
+ */
+uint8_t I2C_IsBusy();
+
+/**
+ * @brief Function called after the host wrote registers of the slave engine.
+ *
+ * @param reg The first register written.
+ * @param length Number of registers written; the range wraps at the end of the register file.
+ *
+ * Runs inside the TWI interrupt, so it must be short.
+ */
+typedef void (*I2C_SlaveWriteCallback)(uint8_t reg, uint8_t length);
+
+/**
+ * @brief Function called when the host starts reading registers of the slave engine.
+ *
+ * @param reg The first register the host will read.
+ *
+ * Runs inside the TWI interrupt before the first byte is sent, so it may
+ * refresh the registers about to be read but must be short.
+ */
+typedef void (*I2C_SlaveReadCallback)(uint8_t reg);
+
+/**
+ * @brief Makes the device answer as an I2C slave with a register file.
+ *
+ * @param address The 7-bit address to answer.
+ * @param registers The register file, in SRAM; it must stay valid while the slave is enabled.
+ * @param size Number of registers, 1 to 255.
+ * @param writeCallback Called after the host wrote registers, or NULL.
+ * @param readCallback Called before the host reads registers, or NULL.
+ *
+ * The host writes a register number followed by data to store from there on,
+ * and reads from the last register number written, with the pointer
+ * auto-incrementing in both directions. Everything runs in TWI_vect, so
+ * interrupts must be enabled; the master functions remain usable.
+ */
+void I2C_InitSlave(uint8_t address, volatile uint8_t *registers, uint8_t size, I2C_SlaveWriteCallback writeCallback,
+                   I2C_SlaveReadCallback readCallback);
+
+/**
+ * @brief Stops answering the slave address.
+ */
+void I2C_StopSlave();
+
 #endif  // I2C_H
@@ -75,6 +75,26 @@ void SPI_MasterTransmit(char data) {
         ;
 }
 
+/*
+ * @brief Exchanges data via SPI communication as master.
+ *
+ * @param data The data byte to be transmitted.
+ *
+ * @return The data byte received while transmitting.
+ *
+ * This function transmits a single byte and returns the byte shifted in on
+ * MISO at the same time, which is how master mode reads from a slave.
+ */
+char SPI_MasterTransfer(char data) {
+    /* Start transmission */
+    SPDR = data;
+    /* Wait for transmission complete */
+    while (!(SPSR & (1 << SPIF)))
+        ;
+    /* Return the byte received during the transmission */
+    return SPDR;
+}
+
 /*
  * @brief Initializes SPI communication as slave.
  *
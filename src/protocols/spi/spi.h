@@ -11,6 +11,14 @@
  */
 #define DDR_SPI DDRB
 
+/*
+ * @brief PORT register for SPI.
+ *
+ * This macro defines the PORT register of the SPI pins, used to enable the
+ * pull-up on MISO.
+ */
+#define PORT_SPI PORTB
+
 /*
  * @brief MOSI pin for SPI.
  *
@@ -54,6 +62,18 @@ void SPI_MasterInit(uint8_t prescaler);
  */
 void SPI_MasterTransmit(char data);
 
+/*
+ * @brief Exchanges data via SPI communication as master.
+ *
+ * @param data The data byte to be transmitted.
+ *
+ * @return The data byte received while transmitting.
+ *
+ * This function transmits a single byte and returns the byte shifted in on
+ * MISO at the same time, which is how master mode reads from a slave.
+ */
+char SPI_MasterTransfer(char data);
+
 /*
  * @brief Initializes SPI communication as slave.
  *
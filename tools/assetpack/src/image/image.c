@@ -0,0 +1,130 @@
+#include "image.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * @brief Computes the hash of a file name, as ASSETFS_Hash does on the device.
+ *
+ * @param name The file name.
+ * @return The hash; its low bits select the bucket.
+ */
+uint16_t asset_hash(const char *name) {
+    uint16_t hash = 5381;
+    while (*name) {
+        hash = (uint16_t)(((hash << 5) + hash) ^ (uint8_t)*name++);
+    }
+    return hash;
+}
+
+/*
+ * @brief Updates a CRC-CCITT with one byte, as _crc_ccitt_update in avr-libc.
+ *
+ * @param crc The running CRC, starting at 0xFFFF.
+ * @param data The byte.
+ * @return The updated CRC.
+ */
+static uint16_t crc_ccitt_update(uint16_t crc, uint8_t data) {
+    data ^= crc & 0xFF;
+    data ^= data << 4;
+    return (uint16_t)((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+/*
+ * @brief Stores a little-endian 16-bit field.
+ *
+ * @param data The first byte of the field.
+ * @param value The field value.
+ */
+static void put16(uint8_t *data, unsigned value) {
+    data[0] = value & 0xFF;
+    data[1] = (value >> 8) & 0xFF;
+}
+
+/*
+ * @brief Returns the bucket of an asset.
+ *
+ * @param asset The asset.
+ * @return The low bits of the name hash.
+ */
+static int asset_bucket(const Asset *asset) {
+    return asset_hash(asset->name) & (ASSETFS_BUCKETS - 1);
+}
+
+/*
+ * @brief Builds a filesystem image.
+ *
+ * The assets are sorted by bucket, the directory is written after the header
+ * page and the contents follow the directory, each in one contiguous extent.
+ *
+ * @param assets The files to pack; they are reordered by bucket.
+ * @param count The number of files.
+ * @param image Receives the image, allocated with malloc.
+ * @param size Receives the size of the image in bytes.
+ * @return 0 on success, -1 if the files do not fit in an image.
+ */
+int build_image(Asset *assets, int count, uint8_t **image, size_t *size) {
+    if (count > ASSETFS_MAX_FILES) {
+        fprintf(stderr, "Too many files (%d, at most %d)\n", count, ASSETFS_MAX_FILES);
+        return -1;
+    }
+
+    size_t total = ASSETFS_DIRECTORY + (size_t)count * ASSETFS_ENTRY_SIZE;
+    for (int i = 0; i < count; i++) {
+        total += assets[i].length;
+    }
+    if (total > ASSETFS_MAX_SIZE) {
+        fprintf(stderr, "Image too large (%zu bytes, at most %d)\n", total, ASSETFS_MAX_SIZE);
+        return -1;
+    }
+
+    // Insertion sort keeps the command-line order within a bucket
+    for (int i = 1; i < count; i++) {
+        Asset asset = assets[i];
+        int j = i;
+        while (j > 0 && asset_bucket(&assets[j - 1]) > asset_bucket(&asset)) {
+            assets[j] = assets[j - 1];
+            j--;
+        }
+        assets[j] = asset;
+    }
+
+    uint8_t *out = calloc(total, 1);
+    if (out == NULL) {
+        perror("calloc");
+        return -1;
+    }
+
+    out[0] = 'A';
+    out[1] = 'F';
+    out[2] = ASSETFS_VERSION;
+    out[3] = (uint8_t)count;
+    int index = 0;
+    for (int bucket = 0; bucket < ASSETFS_BUCKETS; bucket++) {
+        out[4 + bucket] = (uint8_t)index;
+        while (index < count && asset_bucket(&assets[index]) == bucket) {
+            index++;
+        }
+    }
+    put16(&out[4 + ASSETFS_BUCKETS], (unsigned)total);
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < ASSETFS_HEADER_SIZE - 2; i++) {
+        crc = crc_ccitt_update(crc, out[i]);
+    }
+    put16(&out[ASSETFS_HEADER_SIZE - 2], crc);
+
+    size_t offset = ASSETFS_DIRECTORY + (size_t)count * ASSETFS_ENTRY_SIZE;
+    for (int i = 0; i < count; i++) {
+        uint8_t *entry = &out[ASSETFS_DIRECTORY + i * ASSETFS_ENTRY_SIZE];
+        memcpy(entry, assets[i].name, strlen(assets[i].name));
+        put16(&entry[ASSETFS_NAME_SIZE], (unsigned)offset);
+        put16(&entry[ASSETFS_NAME_SIZE + 2], (unsigned)assets[i].length);
+        memcpy(&out[offset], assets[i].data, assets[i].length);
+        offset += assets[i].length;
+    }
+
+    *image = out;
+    *size = total;
+    return 0;
+}
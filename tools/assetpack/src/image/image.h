@@ -0,0 +1,50 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Layout of the asset filesystem image; it must match src/modules/assetfs/assetfs.h.
+ */
+#define ASSETFS_BUCKETS 32
+#define ASSETFS_NAME_SIZE 12
+#define ASSETFS_HEADER_SIZE (6 + ASSETFS_BUCKETS + 2)
+#define ASSETFS_DIRECTORY 64
+#define ASSETFS_ENTRY_SIZE (ASSETFS_NAME_SIZE + 4)
+#define ASSETFS_VERSION 1
+#define ASSETFS_MAX_FILES 255
+#define ASSETFS_MAX_SIZE 32768
+
+/*
+ * @brief A file to be packed.
+ */
+typedef struct {
+    char name[ASSETFS_NAME_SIZE + 1];
+    const uint8_t *data;
+    size_t length;
+} Asset;
+
+/*
+ * @brief Computes the hash of a file name, as ASSETFS_Hash does on the device.
+ *
+ * @param name The file name.
+ * @return The hash; its low bits select the bucket.
+ */
+uint16_t asset_hash(const char *name);
+
+/*
+ * @brief Builds a filesystem image.
+ *
+ * The assets are sorted by bucket, the directory is written after the header
+ * page and the contents follow the directory, each in one contiguous extent.
+ *
+ * @param assets The files to pack; they are reordered by bucket.
+ * @param count The number of files.
+ * @param image Receives the image, allocated with malloc.
+ * @param size Receives the size of the image in bytes.
+ * @return 0 on success, -1 if the files do not fit in an image.
+ */
+int build_image(Asset *assets, int count, uint8_t **image, size_t *size);
+
+#endif /* IMAGE_H */
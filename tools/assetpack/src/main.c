@@ -0,0 +1,122 @@
+#include "main.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * @brief Reads a whole file into memory.
+ *
+ * @param path The path of the file.
+ * @param length Receives the size of the file in bytes.
+ * @return The contents, allocated with malloc, or NULL on error.
+ */
+uint8_t *read_file(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return NULL;
+    }
+
+    uint8_t *data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc(size > 0 ? size : 1);
+        if (data != NULL && fread(data, 1, size, file) != (size_t)size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    if (data == NULL) {
+        fprintf(stderr, "%s: read error\n", path);
+    }
+    fclose(file);
+    *length = (size_t)size;
+    return data;
+}
+
+/*
+ * @brief The main function of the program.
+ *
+ * This is the main entry point of the program. It reads the files named on
+ * the command line, packs them into an asset filesystem image and writes the
+ * image to the output file.
+ *
+ * @param argc The number of command-line arguments passed to the program.
+ * @param argv An array of strings containing the command-line arguments.
+ * @return The exit status of the program.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <image> <file>|<name>=<file> ...\n", argv[0]);
+        fprintf(stderr, "Files are stored under their base name unless a name is given (at most %d characters)\n",
+                ASSETFS_NAME_SIZE);
+        return 1;
+    }
+
+    int count = argc - 2;
+    Asset *assets = calloc(count, sizeof(Asset));
+    if (assets == NULL) {
+        perror("calloc");
+        return 1;
+    }
+
+    int result = 1;
+    for (int i = 0; i < count; i++) {
+        const char *arg = argv[i + 2];
+        const char *path = strchr(arg, '=');
+        const char *name;
+        size_t name_length;
+        if (path != NULL) {
+            name = arg;
+            name_length = path - arg;
+            path++;
+        } else {
+            path = arg;
+            const char *slash = strrchr(arg, '/');
+            name = slash != NULL ? slash + 1 : arg;
+            name_length = strlen(name);
+        }
+
+        if (name_length == 0 || name_length > ASSETFS_NAME_SIZE) {
+            fprintf(stderr, "%s: name must have 1 to %d characters\n", arg, ASSETFS_NAME_SIZE);
+            goto cleanup;
+        }
+        memcpy(assets[i].name, name, name_length);
+        for (int j = 0; j < i; j++) {
+            if (strcmp(assets[j].name, assets[i].name) == 0) {
+                fprintf(stderr, "%s: duplicate name\n", assets[i].name);
+                goto cleanup;
+            }
+        }
+
+        assets[i].data = read_file(path, &assets[i].length);
+        if (assets[i].data == NULL) goto cleanup;
+    }
+
+    uint8_t *image;
+    size_t size;
+    if (build_image(assets, count, &image, &size) == 0) {
+        FILE *file = fopen(argv[1], "wb");
+        if (file == NULL) {
+            perror(argv[1]);
+        } else {
+            int written = fwrite(image, 1, size, file) == size;
+            if (fclose(file) == 0 && written) {
+                printf("Packed %d files into %s (%zu bytes)\n", count, argv[1], size);
+                result = 0;
+            } else {
+                fprintf(stderr, "%s: write error\n", argv[1]);
+            }
+        }
+        free(image);
+    }
+
+cleanup:
+    for (int i = 0; i < count; i++) {
+        free((void *)assets[i].data);
+    }
+    free(assets);
+    return result;
+}
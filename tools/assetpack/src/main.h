@@ -0,0 +1,28 @@
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "image/image.h"
+
+/*
+ * @brief Reads a whole file into memory.
+ *
+ * @param path The path of the file.
+ * @param length Receives the size of the file in bytes.
+ * @return The contents, allocated with malloc, or NULL on error.
+ */
+uint8_t *read_file(const char *path, size_t *length);
+
+/*
+ * @brief The main function of the program.
+ *
+ * This is the main entry point of the program. It reads the files named on
+ * the command line, packs them into an asset filesystem image and writes the
+ * image to the output file.
+ *
+ * @param argc The number of command-line arguments passed to the program.
+ * @param argv An array of strings containing the command-line arguments.
+ * @return The exit status of the program.
+ */
+int main(int argc, char *argv[]);
+
+#endif  // MAIN_H
@@ -66,8 +66,9 @@ void *write_thread_func(void *arg) {
  */
 int main(int argc, char *argv[]) {
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <port> [mode]\n", argv[0]);
-        fprintf(stderr, "Mode (optional): read, write, both (default: both)\n");
+        fprintf(stderr, "Usage: %s <port> [mode] [file]\n", argv[0]);
+        fprintf(stderr, "Mode (optional): read, write, both, screenshot (default: both)\n");
+        fprintf(stderr, "File (screenshot mode): output image, .png or .ppm (default: screenshot.png)\n");
         return 1;
     }
 
@@ -83,6 +84,14 @@ int main(int argc, char *argv[]) {
     set_interface_attribs(fd, B9600);
     set_blocking(fd, 1);
 
+    // A screenshot is a single request/response exchange, no threads needed
+    if (strcmp(mode, "screenshot") == 0) {
+        char *path = (argc > 3) ? argv[3] : "screenshot.png";
+        int result = receive_screenshot(fd, path);
+        close(fd);
+        return result == 0 ? 0 : 1;
+    }
+
     // Data structure to pass to the threads
     SerialData serial_data = {portname, fd};
 
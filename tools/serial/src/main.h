@@ -1,6 +1,7 @@
 #ifndef MAIN_H
 #define MAIN_H
 
+#include "screenshot/screenshot.h"
 #include "tty/tty.h"
 
 /*
@@ -0,0 +1,257 @@
+#include "screenshot.h"
+
+/*
+ * @brief Reads exactly the requested number of bytes from a file descriptor.
+ *
+ * @param fd The file descriptor.
+ * @param buf The buffer receiving the bytes.
+ * @param len The number of bytes to read.
+ * @return 0 on success, -1 on error or end of file.
+ */
+static int read_exact(int fd, uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n <= 0) {
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/*
+ * @brief Requests a screenshot from the device and saves it.
+ *
+ * This function sends the screenshot command, decodes the RGB565 frame sent
+ * back by the device's screenshot module and writes it as a PNG file, or as a
+ * PPM file when the path ends in ".ppm".
+ *
+ * @param fd The file descriptor of the serial port.
+ * @param path The path of the image file to write.
+ * @return 0 on success, -1 on error.
+ */
+int receive_screenshot(int fd, const char *path) {
+    uint8_t command = SCREENSHOT_COMMAND;
+    uint8_t header[8];
+    uint8_t trailer[2];
+
+    if (write(fd, &command, 1) != 1) {
+        perror("write");
+        return -1;
+    }
+
+    // Skip anything the device printed before the frame, up to the magic "ST77"
+    if (read_exact(fd, header, 4) < 0) {
+        fprintf(stderr, "No answer from the device\n");
+        return -1;
+    }
+    while (memcmp(header, "ST77", 4) != 0) {
+        memmove(header, header + 1, 3);
+        if (read_exact(fd, header + 3, 1) < 0) {
+            fprintf(stderr, "No screenshot frame received\n");
+            return -1;
+        }
+    }
+    if (read_exact(fd, header + 4, 4) < 0) {
+        fprintf(stderr, "Truncated frame header\n");
+        return -1;
+    }
+
+    int width = header[4] | (header[5] << 8);
+    int height = header[6] | (header[7] << 8);
+    size_t size = (size_t)width * height * 2;
+    uint8_t *pixels = malloc(size > 0 ? size : 1);
+    uint8_t *rgb = malloc(size > 0 ? (size / 2) * 3 : 1);
+    int result = -1;
+
+    if (pixels == NULL || rgb == NULL) {
+        perror("malloc");
+    } else if (read_exact(fd, pixels, size) < 0 || read_exact(fd, trailer, 2) < 0) {
+        fprintf(stderr, "Truncated frame\n");
+    } else if (width == 0 || height == 0) {
+        fprintf(stderr, "The display cannot be read back (no MISO connection?)\n");
+    } else {
+        uint16_t sum = 0;
+        for (size_t i = 0; i < size; i++) {
+            sum += pixels[i];
+        }
+        if (sum != (trailer[0] | (trailer[1] << 8))) {
+            fprintf(stderr, "Checksum mismatch\n");
+        } else {
+            // Expand RGB565 to RGB888, replicating the high bits into the low ones
+            for (size_t i = 0; i < size / 2; i++) {
+                uint16_t color = (pixels[2 * i] << 8) | pixels[2 * i + 1];
+                uint8_t r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+                rgb[3 * i] = (r << 3) | (r >> 2);
+                rgb[3 * i + 1] = (g << 2) | (g >> 4);
+                rgb[3 * i + 2] = (b << 3) | (b >> 2);
+            }
+
+            size_t len = strlen(path);
+            if (len >= 4 && strcmp(path + len - 4, ".ppm") == 0) {
+                result = write_ppm(path, rgb, width, height);
+            } else {
+                result = write_png(path, rgb, width, height);
+            }
+            if (result == 0) {
+                printf("Saved %dx%d screenshot to %s\n", width, height, path);
+            }
+        }
+    }
+
+    free(pixels);
+    free(rgb);
+    return result;
+}
+
+/*
+ * @brief Writes an RGB888 image as a binary PPM (P6) file.
+ *
+ * @param path The path of the file.
+ * @param rgb The pixels, three bytes each, row-major.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @return 0 on success, -1 on error.
+ */
+int write_ppm(const char *path, const uint8_t *rgb, int width, int height) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("fopen");
+        return -1;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    fwrite(rgb, 3, (size_t)width * height, file);
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+/*
+ * @brief Updates a PNG chunk CRC-32 with a block of bytes.
+ *
+ * @param crc The running CRC, starting at 0.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @return The updated CRC.
+ */
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/*
+ * @brief Writes a 32-bit value in big-endian order.
+ *
+ * @param out The destination.
+ * @param value The value.
+ */
+static void put_be32(uint8_t *out, uint32_t value) {
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+}
+
+/*
+ * @brief Writes a PNG chunk.
+ *
+ * @param file The file.
+ * @param type The four-letter chunk type.
+ * @param data The chunk data.
+ * @param len The length of the chunk data.
+ */
+static void write_chunk(FILE *file, const char *type, const uint8_t *data, size_t len) {
+    uint8_t word[4];
+    put_be32(word, len);
+    fwrite(word, 1, 4, file);
+    fwrite(type, 1, 4, file);
+    fwrite(data, 1, len, file);
+    put_be32(word, crc32_update(crc32_update(0, (const uint8_t *)type, 4), data, len));
+    fwrite(word, 1, 4, file);
+}
+
+/*
+ * @brief Writes an RGB888 image as a PNG file.
+ *
+ * The image data is stored in uncompressed deflate blocks, so no compression
+ * library is needed.
+ *
+ * @param path The path of the file.
+ * @param rgb The pixels, three bytes each, row-major.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @return 0 on success, -1 on error.
+ */
+int write_png(const char *path, const uint8_t *rgb, int width, int height) {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    size_t stride = (size_t)width * 3 + 1;  // Filter byte plus the row
+    size_t raw_len = stride * height;
+    size_t blocks = (raw_len + 65534) / 65535;
+    uint8_t *raw = malloc(raw_len);
+    uint8_t *zlib = malloc(2 + blocks * 5 + raw_len + 4);
+
+    if (raw == NULL || zlib == NULL) {
+        perror("malloc");
+        free(raw);
+        free(zlib);
+        return -1;
+    }
+
+    // Filter type 0 (none) on every row
+    for (int y = 0; y < height; y++) {
+        raw[y * stride] = 0;
+        memcpy(raw + y * stride + 1, rgb + (size_t)y * width * 3, (size_t)width * 3);
+    }
+
+    // zlib stream of stored deflate blocks, followed by the Adler-32 of the raw data
+    size_t pos = 0;
+    zlib[pos++] = 0x78;
+    zlib[pos++] = 0x01;
+    for (size_t offset = 0; offset < raw_len; offset += 65535) {
+        size_t len = raw_len - offset < 65535 ? raw_len - offset : 65535;
+        zlib[pos++] = (offset + len == raw_len) ? 1 : 0;  // BFINAL on the last block
+        zlib[pos++] = len & 0xFF;
+        zlib[pos++] = len >> 8;
+        zlib[pos++] = ~len & 0xFF;
+        zlib[pos++] = (~len >> 8) & 0xFF;
+        memcpy(zlib + pos, raw + offset, len);
+        pos += len;
+    }
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < raw_len; i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_be32(zlib + pos, (b << 16) | a);
+    pos += 4;
+
+    uint8_t ihdr[13];
+    put_be32(ihdr, width);
+    put_be32(ihdr + 4, height);
+    ihdr[8] = 8;   // Bit depth
+    ihdr[9] = 2;   // Color type: truecolor
+    ihdr[10] = 0;  // Compression method
+    ihdr[11] = 0;  // Filter method
+    ihdr[12] = 0;  // No interlace
+
+    int result = -1;
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("fopen");
+    } else {
+        fwrite(signature, 1, sizeof(signature), file);
+        write_chunk(file, "IHDR", ihdr, sizeof(ihdr));
+        write_chunk(file, "IDAT", zlib, pos);
+        write_chunk(file, "IEND", NULL, 0);
+        result = fclose(file) == 0 ? 0 : -1;
+    }
+
+    free(raw);
+    free(zlib);
+    return result;
+}
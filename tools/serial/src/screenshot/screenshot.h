@@ -0,0 +1,53 @@
+#ifndef SCREENSHOT_H
+#define SCREENSHOT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * @brief Command byte that asks the device for a screenshot.
+ */
+#define SCREENSHOT_COMMAND 'S'
+
+/*
+ * @brief Requests a screenshot from the device and saves it.
+ *
+ * This function sends the screenshot command, decodes the RGB565 frame sent
+ * back by the device's screenshot module and writes it as a PNG file, or as a
+ * PPM file when the path ends in ".ppm".
+ *
+ * @param fd The file descriptor of the serial port.
+ * @param path The path of the image file to write.
+ * @return 0 on success, -1 on error.
+ */
+int receive_screenshot(int fd, const char *path);
+
+/*
+ * @brief Writes an RGB888 image as a binary PPM (P6) file.
+ *
+ * @param path The path of the file.
+ * @param rgb The pixels, three bytes each, row-major.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @return 0 on success, -1 on error.
+ */
+int write_ppm(const char *path, const uint8_t *rgb, int width, int height);
+
+/*
+ * @brief Writes an RGB888 image as a PNG file.
+ *
+ * The image data is stored in uncompressed deflate blocks, so no compression
+ * library is needed.
+ *
+ * @param path The path of the file.
+ * @param rgb The pixels, three bytes each, row-major.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @return 0 on success, -1 on error.
+ */
+int write_png(const char *path, const uint8_t *rgb, int width, int height);
+
+#endif /* SCREENSHOT_H */